@@ -0,0 +1,37 @@
+#!/bin/bash
+# Writes the C++ table of every file of inputs/, compiled in the binary by
+# `make embedded`. The output is only replaced if its content changed.
+set -e
+
+output=$1
+mkdir -p "$(dirname "$output")"
+
+{
+    echo "// Generated by embed_inputs.sh from inputs/, do not edit"
+    echo
+
+    files=$(find inputs -type f | LC_ALL=C sort)
+
+    i=0
+    for file in $files; do
+        echo "static const unsigned char Embedded_File_$i[] = {"
+        od -An -v -tu1 "$file" | sed -E 's/^ +//; s/ +/,/g; s/$/,/'
+        echo "0 };"
+        i=$((i + 1))
+    done
+
+    echo
+    echo "static const EmbeddedFile Embedded_Files[] = {"
+    i=0
+    for file in $files; do
+        echo "    { \"$file\", Embedded_File_$i, $(wc -c < "$file") },"
+        i=$((i + 1))
+    done
+    echo "};"
+} > "$output.tmp"
+
+if cmp -s "$output.tmp" "$output"; then
+    rm "$output.tmp"
+else
+    mv "$output.tmp" "$output"
+fi
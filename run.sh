@@ -2,5 +2,5 @@
 set -e
 
 files=$(find . -type f -name *.cpp)
-g++ $files -o main -std=c++2a -Wall -Wextra -Wpedantic -O3
+g++ $files -o main -std=c++2a -Wall -Wextra -Wpedantic -O3 -pthread
 time ./main $1
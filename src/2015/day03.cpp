@@ -1,7 +1,6 @@
 #include "../advent_of_code.hpp"
 #include "../util/position.hpp"
-
-#include <set>
+#include "../util/flat_hash.hpp"
 
 // https://adventofcode.com/2015/day/3
 
@@ -31,7 +30,7 @@ namespace {
 
     template <typename VisitStrategy>
     struct Santa {
-        std::set<bj::Position> m_visited_houses;
+        bj::FlatHashSet<bj::Position> m_visited_houses;
         VisitStrategy m_strategy;
         
         Santa() { m_visited_houses.insert(*m_strategy); }
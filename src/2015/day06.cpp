@@ -1,8 +1,9 @@
 #include "../advent_of_code.hpp"
+#include "../util/big_buffer.hpp"
+#include "../util/bit_grid.hpp"
 #include "../util/position.hpp"
 
 #include <algorithm>
-#include <array>
 #include <numeric>
 #include <regex>
 
@@ -18,22 +19,18 @@ namespace {
         InstructionType type;
         bj::Rectangle area;
 
-        template <typename Collection>
-        void apply(Collection & switch_lights) const {
-            area.for_each_position([&](bj::Position position) {
-                auto & light = switch_lights[position.x * 1000 + position.y];
-                switch (type) {
-                    case InstructionType::TurnOn:
-                        light = 1;
-                        break;
-                    case InstructionType::TurnOff:
-                        light = 0;
-                        break;
-                    case InstructionType::Toggle:
-                        light = 1 - light;
-                        break;
-                }
-            });
+        void apply(bj::BitGrid & switch_lights) const {
+            switch (type) {
+                case InstructionType::TurnOn:
+                    switch_lights.set_rectangle(area.left, area.top, area.right, area.bottom);
+                    break;
+                case InstructionType::TurnOff:
+                    switch_lights.clear_rectangle(area.left, area.top, area.right, area.bottom);
+                    break;
+                case InstructionType::Toggle:
+                    switch_lights.toggle_rectangle(area.left, area.top, area.right, area.bottom);
+                    break;
+            }
         }
         
         template <typename Collection>
@@ -89,13 +86,8 @@ Output day_2015_06(const std::vector<std::string> & lines, const DayExtraInfo &)
     const std::vector<Instruction> instructions =
         lines_transform::map<Instruction>(lines, InstructionMaker{});
 
-    std::vector<int /* bool */> lights;
-    std::vector<Brightness>     bright_lights;
-
-    for (size_t i = 0 ; i != 1000 * 1000 ; ++i) {
-        lights.push_back(0);
-        bright_lights.push_back(0);
-    }
+    bj::BitGrid             lights(1000, 1000);
+    bj::BigBuffer<Brightness> bright_lights(1000 * 1000, 0);
    
     for (const auto & instruction : instructions) {
         instruction.apply(lights);
@@ -103,7 +95,7 @@ Output day_2015_06(const std::vector<std::string> & lines, const DayExtraInfo &)
     }
 
     return Output(
-        std::reduce(lights.begin(), lights.end()),
+        lights.count(),
         std::reduce(bright_lights.begin(), bright_lights.end())
     );
 }
@@ -1,33 +1,37 @@
 #include "../advent_of_code.hpp"
+#include "../util/string_split.hpp"
+#include "../util/symbol_table.hpp"
 
 #include <variant>
 #include <regex>
+#include <span>
 
 // https://adventofcode.com/2015/day/7
 
 namespace {
     enum class Operator { And, Or, LShift, Not, RShift, Assign };
-    using Source = std::variant<std::uint16_t, std::string>;
+    struct Wire { bj::SymbolId id; };
+    using Source = std::variant<std::uint16_t, Wire>;
 
     struct Formula {
         Source   lhs;
         Operator op;
         Source   rhs;
 
-        explicit Formula(const std::vector<std::string> & values) {
+        Formula(std::span<const std::string_view> values, bj::SymbolTable & wires) {
             if (values.size() == 3) {
                 /* VAL -> dest */
-                lhs = 0;
-                rhs = to_value(values[0]);
+                lhs = std::uint16_t(0);
+                rhs = to_value(values[0], wires);
                 op = Operator::Assign;
             } else if (values.size() == 4) {
                 /* NOT VAL -> dest */
-                lhs = 0;
-                rhs = to_value(values[1]);
+                lhs = std::uint16_t(0);
+                rhs = to_value(values[1], wires);
                 op = Operator::Not;
             } else {
-                lhs = to_value(values[0]);
-                rhs = to_value(values[2]);
+                lhs = to_value(values[0], wires);
+                rhs = to_value(values[2], wires);
 
                 if (values[1] == "AND") {
                     op = Operator::And;
@@ -43,56 +47,71 @@ namespace {
             }
         }
         
-        /* implicit */ Formula(uint16_t value) : lhs(0), op(Operator::Assign), rhs(value) {}
+        /* implicit */ Formula(uint16_t value) : lhs(std::uint16_t(0)), op(Operator::Assign), rhs(value) {}
 
-        [[nodiscard]] static Source to_value(const std::string & s) {
+        [[nodiscard]] static Source to_value(std::string_view s, bj::SymbolTable & wires) {
             if (s[0] >= '0' && s[0] <= '9') {
-                return std::stoi(s);
+                return bj::to_int<std::uint16_t>(s);
             } else {
-                return s;
+                return Wire { wires.intern(s) };
             }
         }
     };
 
     struct WireValue {
-        Formula                 formula;
+        Formula                 formula = Formula(0);
         std::optional<uint16_t> value = std::nullopt;
     };
 
     class WireNetwork {
-        std::map<std::string, WireValue> m_wires;
+        bj::SymbolTable             m_names;
+        bj::SymbolVector<WireValue> m_wires;
 
     public:
         explicit WireNetwork(const std::vector<std::string> & instructions) {
+            // At most: lhs OPERATOR rhs -> destination
+            std::array<std::string_view, 5> values;
+
             for (const auto & wire_instruction : instructions) {
-                std::vector<std::string> values = StringSplitter::line_to_vector<std::string>(
-                    wire_instruction, [](const std::string & s) { return s; }, ' '
-                );
+                size_t nb_values = 0;
+                for (const std::string_view value : bj::split(wire_instruction)) {
+                    if (nb_values == values.size()) break;
+                    values[nb_values++] = value;
+                }
 
-                m_wires.emplace(values.back(), WireValue { Formula { values } });
+                const auto formula_values = std::span<const std::string_view>(values.data(), nb_values);
+                const bj::SymbolId destination = m_names.intern(formula_values.back());
+                m_wires[destination] = WireValue { Formula { formula_values, m_names } };
             }
         }
 
         /// Replace the wire with a new formula
-        void set_wire(const std::string & wire_name, const Formula & new_formula) {
-            m_wires.insert_or_assign(wire_name, WireValue { new_formula });
+        void set_wire(std::string_view wire_name, const Formula & new_formula) {
+            m_wires[m_names.intern(wire_name)] = WireValue { new_formula };
 
             // Reset the wires value
-            for (auto & [_wire_name, data] : m_wires) {
+            for (WireValue & data : m_wires) {
                 data.value = std::nullopt;
             }
         }
         
         /// Returns the value of the wire
-        [[nodiscard]] std::uint16_t get_wire(const std::string & wire_name) {
-            ensure_has_value(wire_name);
-            return m_wires.find(wire_name)->second.value.value();
+        [[nodiscard]] std::uint16_t get_wire(std::string_view wire_name) {
+            return get_wire(Wire { m_names.intern(wire_name) });
+        }
+
+        [[nodiscard]] std::uint16_t get_wire(Wire wire) {
+            ensure_has_value(wire);
+            return m_wires[wire.id].value.value();
         }
 
         /// Ensure the value of the wire is known
-        void ensure_has_value(std::string wire_name) {
-            if (auto & wire_value = m_wires.find(wire_name)->second; !wire_value.value.has_value()) {
-                wire_value.value = evaluate(wire_value.formula);
+        void ensure_has_value(Wire wire) {
+            if (!m_wires[wire.id].value.has_value()) {
+                // Copied: evaluating may grow m_wires
+                const Formula formula = m_wires[wire.id].formula;
+                const std::uint16_t value = evaluate(formula);
+                m_wires[wire.id].value = value;
             }
         }
         
@@ -113,7 +132,7 @@ namespace {
         [[nodiscard]] uint16_t get_value(const Source & value) {
             if (const auto * int_value = std::get_if<uint16_t>(&value)) {
                 return *int_value;
-            } else if (const auto * wire = std::get_if<std::string>(&value)) {
+            } else if (const auto * wire = std::get_if<Wire>(&value)) {
                 return get_wire(*wire);
             } else {
                 return 0;
@@ -1,100 +1,96 @@
 #include "../advent_of_code.hpp"
+#include "../util/branch_and_bound.hpp"
+#include "../util/string_split.hpp"
+#include "../util/symbol_table.hpp"
 
-#include <set>
-#include <map>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
 
 // https://adventofcode.com/2015/day/9
 
 namespace {
-    using City = std::string;
-
-    struct Distances {
-        std::map<std::pair<City, City>, int> m_data;
-
-        void insert(City city1, City city2, int distance) {
-            if (city1 > city2) {
-                insert(city2, city1, distance);
-                return;
-            }
-
-            m_data.insert_or_assign(std::pair<City, City>(city1, city2), distance);
-        }
-
-        int get(const City &  city1, const City & city2) const {
-            if (city1 > city2) return get(city2, city1);
-            return m_data.find(std::pair<City, City>(city1, city2))->second;
-        }
-
-        void flip() {
-            for (auto & [city, distance] : m_data) {
-                distance *= -1;
-            }
-        }
-    }; 
-
-    struct VisitableCity {
-        City name;
-        bool visited = false;
+    using City = bj::SymbolId;
+
+    /** Bit c is set if the city c was visited */
+    using Visited = std::uint64_t;
+    static constexpr size_t Max_Cities = 64;
+
+    /** A path that is being built */
+    struct Path {
+        std::optional<City> last;
+        Visited visited = 0;
+        int length = 0;
+        int nb_visited = 0;
     };
 
-    int find_smaller_path(const City & from, std::vector<VisitableCity> & visitables, const Distances & distances, int current, int current_best) {
-        if (std::all_of(visitables.begin(), visitables.end(), [](const VisitableCity & c) { return c.visited; })) {
-            return std::min(current, current_best); // current should always be < to current_best
-        }
-
-        for (auto & visitable : visitables) {
-            if (visitable.visited) continue;
-
-            const int distance = from == "" ? 0 : distances.get(from, visitable.name);
-
-            if (distance > 0 && current + distance > current_best) continue;
-
-            visitable.visited = true;
-
-            const int best_in_branch = find_smaller_path(visitable.name, visitables, distances, current + distance, current_best);
-
-            if (best_in_branch < current_best) {
-                current_best = best_in_branch;
+    /**
+     * The shortest (or longest) path that visits every city once, with a
+     * bound that assumes that every missing step is the shortest (or the
+     * longest) possible.
+     */
+    template <bool Shortest>
+    std::optional<int> find_best_path(size_t nb_cities, const bj::SymbolMatrix<int> & distances) {
+        int best_step = Shortest ? std::numeric_limits<int>::max() : std::numeric_limits<int>::lowest();
+        for (City city1 = 0 ; city1 != nb_cities ; ++city1) {
+            for (City city2 = 0 ; city2 != nb_cities ; ++city2) {
+                if (city1 == city2) continue;
+                best_step = Shortest ? std::min(best_step, distances(city1, city2)) : std::max(best_step, distances(city1, city2));
             }
-
-            visitable.visited = false;
         }
 
-        return current_best;
-    }
+        const auto children = [&](const Path & path, auto && emit) {
+            for (City city = 0 ; city != nb_cities ; ++city) {
+                if (path.visited & (Visited(1) << city)) continue;
 
-    int find_smaller_path(const std::set<City> & cities, const Distances & distances) {
-        std::vector<VisitableCity> visitable;
-        for (const auto & city : cities) {
-            visitable.push_back(VisitableCity { city });
+                emit(Path {
+                    city,
+                    path.visited | (Visited(1) << city),
+                    path.length + (path.last ? distances(*path.last, city) : 0),
+                    path.nb_visited + 1
+                });
+            }
+        };
+
+        const auto bound = [&](const Path & path) {
+            const int missing_steps = static_cast<int>(nb_cities) - std::max(path.nb_visited, 1);
+            return path.length + missing_steps * best_step;
+        };
+
+        const auto evaluate = [&](const Path & path) -> std::optional<int> {
+            if (path.nb_visited != static_cast<int>(nb_cities)) return std::nullopt;
+            return path.length;
+        };
+
+        if constexpr (Shortest) {
+            return bj::branch_and_bound::minimize<int>(Path {}, children, bound, evaluate);
+        } else {
+            return bj::branch_and_bound::maximize<int>(Path {}, children, bound, evaluate);
         }
-
-        return find_smaller_path("", visitable, distances, 0, 2100000000);
     }
 }
 
 Output day_2015_09(const std::vector<std::string> & lines, const DayExtraInfo &) {
-    std::set<std::string> cities;
-    Distances distances;
+    bj::SymbolTable cities;
+    bj::SymbolMatrix<int> distances;
 
     for (const auto & line : lines) {
-        StringSplitter splitter { line };
+        const auto [city1, _to, city2, _equal, distance] = bj::split_n<5>(line);
 
-        const std::string city1 = splitter();
-        splitter();
-        const std::string city2 = splitter();
-        splitter();
-        const unsigned int distance = std::stoul(splitter());
+        const City id1 = cities.intern(city1);
+        const City id2 = cities.intern(city2);
+        distances(id1, id2) = bj::to_int(distance);
+        distances(id2, id1) = bj::to_int(distance);
+    }
 
-        cities.insert(city1);
-        cities.insert(city2);
-        distances.insert(city1, city2, distance);
+    if (cities.size() > Max_Cities) {
+        std::cerr << "2015-09: at most " << Max_Cities << " cities are supported\n";
+        exit(EXIT_FAILURE);
     }
 
-    const auto smaller_path = find_smaller_path(cities, distances);
-    // Find longest path = find smaller path if the distances are negatives!
-    distances.flip();
-    const auto longest_path = find_smaller_path(cities, distances);
+    const auto smaller_path = find_best_path<true >(cities.size(), distances);
+    const auto longest_path = find_best_path<false>(cities.size(), distances);
 
-    return Output(smaller_path, -longest_path);
+    return Output(smaller_path.value(), longest_path.value());
 }
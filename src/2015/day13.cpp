@@ -1,17 +1,22 @@
 #include "../advent_of_code.hpp"
+#include "../util/branch_and_bound.hpp"
+#include "../util/symbol_table.hpp"
 #include <regex>
 
-#include <set>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <vector>
 
 // https://adventofcode.com/2015/day/13
 
 namespace {
-    using Person = std::string;
+    using Person = bj::SymbolId;
     using Position = int;
 
     struct Relationship {
-        std::map<Person, std::map<Person, int>> m_happiness_gain;
+        bj::SymbolTable m_persons;
+        bj::SymbolMatrix<int> m_happiness_gain;
 
         explicit Relationship(const std::vector<std::string> & lines) {
             std::regex regex { R"(^([A-Za-z]*) would (gain|lose) ([0-9]+) happiness units by sitting next to ([A-Za-z]*)\.$)" };
@@ -20,123 +25,114 @@ namespace {
             for (const auto & line : lines) {
                 std::regex_search(line, smatch_, regex);
 
-                const auto person1 = smatch_[1].str();
-                const auto person2 = smatch_[4].str();
+                const auto person1 = m_persons.intern(smatch_[1].str());
+                const auto person2 = m_persons.intern(smatch_[4].str());
                 const auto is_gain = smatch_[2].str() == "gain";
                 const auto value = std::stoi(smatch_[3].str());
                 
-                m_happiness_gain[person1][person2] = value * (is_gain ? 1 : -1);
+                m_happiness_gain(person1, person2) = value * (is_gain ? 1 : -1);
             }
-        }
 
-        void add(Person subject, Person object, int gain) {
-            m_happiness_gain[subject][object] = gain;
+            m_happiness_gain.resize(m_persons.size());
         }
     };
 
     struct GlobalHappinness {
-        std::map<std::pair<Person, Person>, int> m_global_gain;
-
-        explicit GlobalHappinness(const Relationship & relations) {
-            for (const auto & [person, map] : relations.m_happiness_gain) {
-                for (const auto & [other, gain] : map) {
-                    add(person, other, gain);
+        bj::SymbolTable m_persons;
+        bj::SymbolMatrix<int> m_global_gain;
+
+        explicit GlobalHappinness(const Relationship & relations)
+        : m_persons(relations.m_persons), m_global_gain(relations.m_persons.size()) {
+            for (Person person = 0 ; person != m_persons.size() ; ++person) {
+                for (Person other = 0 ; other != m_persons.size() ; ++other) {
+                    add(person, other, relations.m_happiness_gain(person, other));
                 }
             }
         }
 
-        void add(const Person & person, const Person & other, int gain) {
-            const auto key = person < other ? std::pair<Person, Person>(person, other) : std::pair<Person, Person>(other, person);
-            m_global_gain[key] += gain;
+        void add(Person person, Person other, int gain) {
+            m_global_gain(person, other) += gain;
+            if (person != other) m_global_gain(other, person) += gain;
         }
 
-        [[nodiscard]] int get_gain(const Person & p1, const Person & p2) const {
-            if (p1 > p2) return get_gain(p2, p1);
-            return m_global_gain.find(std::pair<Person, Person>(p1, p2))->second;
+        [[nodiscard]] int get_gain(Person p1, Person p2) const {
+            return m_global_gain(p1, p2);
         }
 
         [[nodiscard]] std::vector<Person> get_persons() const {
-            std::set<Person> persons;
-            for (auto & [persons_in_pair, _] : m_global_gain) {
-                persons.insert(persons_in_pair.first);
-                persons.insert(persons_in_pair.second);
+            std::vector<Person> persons;
+            for (Person person = 0 ; person != m_persons.size() ; ++person) {
+                persons.push_back(person);
             }
 
-            return std::vector<Person>(persons.begin(), persons.end());
+            return persons;
         }
 
-        void add(Person swiss_person) {
-            for (const auto & other : get_persons()) {
-                add(swiss_person, other, 0);
-            }
+        void add(std::string_view swiss_person) {
+            // The swiss person is neutral: all its gains are 0
+            m_persons.intern(swiss_person);
+            m_global_gain.resize(m_persons.size());
         }
     };
 
 
-    struct Explorer {
-        const GlobalHappinness & m_happiness;
+    /** Bit p is set if the person p is seated */
+    using Seated = std::uint64_t;
+    static constexpr size_t Max_Persons = 64;
 
-        // In general, I'm not fond of using const members in C++, but here, it acts more as
-        // a local global variable than a real class, so I prefer to ensure that it is const
-        // accross the use of the class over being able to copy
-        const std::vector<Person> m_persons;
-        std::vector<bool> m_has_been_assigned;
+    /** A table where the first places are taken */
+    struct Seating {
+        Person first;
+        Person last;
+        Seated seated = 0;
+        int nb_seated = 0;
+        int happiness = 0;
+    };
 
-        std::vector<Person> m_places;
+    int maximize_happiness(const GlobalHappinness & global) {
+        const auto persons = global.get_persons();
+        const int nb_persons = static_cast<int>(persons.size());
 
-        Explorer(const GlobalHappinness & happiness, std::vector<Person> persons, std::vector<bool> has_been_assigned, std::vector<Person> places)
-        : m_happiness(happiness), m_persons(persons), m_has_been_assigned(has_been_assigned), m_places(places) {
-            m_has_been_assigned[0] = true;
-            m_places.push_back(m_persons.front());
+        if (persons.size() > Max_Persons) {
+            std::cerr << "2015-13: at most " << Max_Persons << " persons are supported\n";
+            exit(EXIT_FAILURE);
         }
 
-        int compute_current_happiness() const {
-            int total = 0;
-
-            for (size_t i = 0 ; i != m_places.size() ; ++i) {
-                const Person & me = m_places[i];
-                const Person & you = m_places[(i + 1) % m_places.size()];
-                total += m_happiness.get_gain(me, you);
+        int best_gain = std::numeric_limits<int>::lowest();
+        for (const Person person : persons) {
+            for (const Person other : persons) {
+                if (person != other) best_gain = std::max(best_gain, global.get_gain(person, other));
             }
-
-            return total;
         }
 
-        int maximize_happiness() {
-            if (m_places.size() == m_persons.size()) {
-                return compute_current_happiness();
-            }
-
-            std::optional<int> best_local_happiness = std::nullopt;
-
-            for (size_t i = 0 ; i != m_persons.size() ; ++i) {
-                if (m_has_been_assigned[i]) continue;
+        const auto children = [&](const Seating & seating, auto && emit) {
+            for (const Person person : persons) {
+                if (seating.seated & (Seated(1) << person)) continue;
 
-                m_places.push_back(m_persons[i]);
-                m_has_been_assigned[i] = true;
-
-                const int happy = maximize_happiness();
-                if (!best_local_happiness || happy > *best_local_happiness) {
-                    best_local_happiness = happy;
-                }
-
-                m_has_been_assigned[i] = false;
-                m_places.pop_back();
+                emit(Seating {
+                    seating.first, person,
+                    seating.seated | (Seated(1) << person),
+                    seating.nb_seated + 1,
+                    seating.happiness + global.get_gain(seating.last, person)
+                });
             }
-
-            return *best_local_happiness;
-        }
-    };
-
-    int maximize_happiness(const GlobalHappinness & global) {
-        const auto persons = global.get_persons();
-        std::vector<bool> assigned;
-        for (size_t i = 0 ; i != persons.size() ; ++i) assigned.push_back(false);
-
-        std::vector<Person> places;
-
-        Explorer explorer { global, persons, assigned, places };
-        return explorer.maximize_happiness();
+        };
+
+        // Every missing neighbourhood, including the one that closes the
+        // table, is at best the best gain
+        const auto bound = [&](const Seating & seating) {
+            return seating.happiness + (nb_persons - seating.nb_seated + 1) * best_gain;
+        };
+
+        const auto evaluate = [&](const Seating & seating) -> std::optional<int> {
+            if (seating.nb_seated != nb_persons) return std::nullopt;
+            return seating.happiness + global.get_gain(seating.last, seating.first);
+        };
+
+        // The table is round: the first person can be anywhere
+        const Person first = persons.front();
+        const Seating root { first, first, Seated(1) << first, 1, 0 };
+        return bj::branch_and_bound::maximize<int>(root, children, bound, evaluate).value();
     }
     
     int maximize_happiness(const GlobalHappinness & global, std::string new_person) {
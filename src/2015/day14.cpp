@@ -1,5 +1,6 @@
 #include "../advent_of_code.hpp"
 #include "../util/regex_helper.hpp"
+#include "../util/string_split.hpp"
 
 #include <vector>
 
@@ -14,9 +15,9 @@ namespace {
         unsigned long long int flight_time;
         unsigned long long int rest_time;
 
-        Reindeer(const std::vector<std::string> & values)
-        : name(values[0]), flight_speed(std::stoul(values[1])),
-        flight_time(std::stoul(values[2])), rest_time(std::stoul(values[3])) {}
+        Reindeer(bj::RegexCaptures values)
+        : name(values[0]), flight_speed(bj::to_int<unsigned long long int>(values[1])),
+        flight_time(bj::to_int<unsigned long long int>(values[2])), rest_time(bj::to_int<unsigned long long int>(values[3])) {}
     };
 
     struct Competitor {
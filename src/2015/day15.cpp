@@ -1,6 +1,9 @@
 #include "../advent_of_code.hpp"
+#include "../util/branch_and_bound.hpp"
 #include "../util/regex_helper.hpp"
+#include "../util/string_split.hpp"
 
+#include <algorithm>
 #include <vector>
 
 // https://adventofcode.com/2015/day/15
@@ -15,12 +18,12 @@ namespace {
 
         Property() = default;
 
-        explicit Property(const std::vector<std::string> & values) {
-            capacity   = std::stoi(values[1]);
-            durability = std::stoi(values[2]);
-            flavor     = std::stoi(values[3]);
-            texture    = std::stoi(values[4]);
-            calories   = std::stoi(values[5]);
+        explicit Property(bj::RegexCaptures values) {
+            capacity   = bj::to_int<int64_t>(values[1]);
+            durability = bj::to_int<int64_t>(values[2]);
+            flavor     = bj::to_int<int64_t>(values[3]);
+            texture    = bj::to_int<int64_t>(values[4]);
+            calories   = bj::to_int<int64_t>(values[5]);
         }
 
         Property & operator+=(const Property & rhs) {
@@ -83,31 +86,60 @@ namespace {
         std::string name;
         Property properties;
 
-        Ingredient(const std::vector<std::string> & values)
+        Ingredient(bj::RegexCaptures values)
         : name(values[0]), properties(values) {}
     };
 
-    template <typename Validation>
-    std::optional<Property> naive_picking(const std::vector<Ingredient> & ingredients, unsigned int left, const Validation & validation, size_t i_ing = 0, Property prop = Property()) {
-        if (i_ing == ingredients.size() - 1) {
-            prop += ingredients[i_ing].properties * left;
+    /** A recipe where the teaspoons of the first ingredients are chosen */
+    struct Recipe {
+        size_t next_ingredient = 0;
+        unsigned int left;
+        Property properties;
+    };
 
-            if (validation(prop)) return prop;
-            else                  return std::nullopt;
+    template <typename Validation>
+    std::optional<int64_t> best_recipe(const std::vector<Ingredient> & ingredients, unsigned int total, const Validation & validation) {
+        // best_from[i] = property by property, the best ingredient in [i, end[
+        std::vector<Property> best_from(ingredients.size());
+        best_from.back() = ingredients.back().properties;
+        for (size_t i = ingredients.size() - 1 ; i-- > 0 ;) {
+            const Property & mine = ingredients[i].properties;
+            const Property & next = best_from[i + 1];
+            best_from[i].capacity   = std::max(mine.capacity  , next.capacity);
+            best_from[i].durability = std::max(mine.durability, next.durability);
+            best_from[i].flavor     = std::max(mine.flavor    , next.flavor);
+            best_from[i].texture    = std::max(mine.texture   , next.texture);
         }
 
-        std::optional<Property> current_best = std::nullopt;
+        const auto children = [&](const Recipe & recipe, auto && emit) {
+            if (recipe.next_ingredient == ingredients.size()) return;
 
-        for (size_t i = 0 ; i != left ; ++i) {
-            auto branch_prop = naive_picking(ingredients, left - i, validation, i_ing + 1, prop + ingredients[i_ing].properties * i);
-            if (!branch_prop) continue;
-
-            if (!current_best || *branch_prop > *current_best) {
-                current_best = branch_prop;
+            const Property & properties = ingredients[recipe.next_ingredient].properties;
+            if (recipe.next_ingredient == ingredients.size() - 1) {
+                // The last ingredient takes what is left
+                emit(Recipe { recipe.next_ingredient + 1, 0, recipe.properties + properties * recipe.left });
+                return;
             }
-        }
 
-        return current_best;
+            for (unsigned int i = 0 ; i != recipe.left ; ++i) {
+                emit(Recipe { recipe.next_ingredient + 1, recipe.left - i, recipe.properties + properties * i });
+            }
+        };
+
+        // Each property can at best get all the remaining teaspoons of the
+        // best ingredient for it
+        const auto bound = [&](const Recipe & recipe) {
+            if (recipe.next_ingredient == ingredients.size()) return recipe.properties.evaluate();
+            return (recipe.properties + best_from[recipe.next_ingredient] * recipe.left).evaluate();
+        };
+
+        const auto evaluate = [&](const Recipe & recipe) -> std::optional<int64_t> {
+            if (recipe.next_ingredient != ingredients.size()) return std::nullopt;
+            if (!validation(recipe.properties)) return std::nullopt;
+            return recipe.properties.evaluate();
+        };
+
+        return bj::branch_and_bound::maximize<int64_t>(Recipe { 0, total, Property() }, children, bound, evaluate);
     }
 }
 
@@ -115,10 +147,10 @@ Output day_2015_15(const std::vector<std::string> & lines, const DayExtraInfo &)
     const std::vector<Ingredient> ingredients = bj::lines_to_class_by_regex<Ingredient>(lines);
 
     // If we would like to get the exact recipee, we should add another return value which is the (reverse) picked ingredients
-    // to the naive_picking function.
+    // to the best_recipe function.
 
-    const std::optional<Property> optimal        = naive_picking(ingredients, 100, [](const Property &) { return true; });
-    const std::optional<Property> optimal_500cal = naive_picking(ingredients, 100, [](const Property & prop) { return prop.calories == 500; });
+    const std::optional<int64_t> optimal        = best_recipe(ingredients, 100, [](const Property &) { return true; });
+    const std::optional<int64_t> optimal_500cal = best_recipe(ingredients, 100, [](const Property & prop) { return prop.calories == 500; });
 
-    return Output(optimal->evaluate(), optimal_500cal->evaluate());
+    return Output(optimal.value(), optimal_500cal.value());
 }
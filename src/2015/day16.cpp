@@ -1,5 +1,6 @@
 #include "../advent_of_code.hpp"
 #include "../util/regex_helper.hpp"
+#include "../util/string_split.hpp"
 
 #include <map>
 
@@ -12,11 +13,11 @@ namespace {
         int number;
         std::map<std::string, int> properties;
 
-        explicit Sue(const std::vector<std::string> & values) {
-            number = std::stoi(values[0]);
-            properties[values[1]] = std::stoi(values[2]);
-            properties[values[3]] = std::stoi(values[4]);
-            properties[values[5]] = std::stoi(values[6]);
+        explicit Sue(bj::RegexCaptures values) {
+            number = bj::to_int(values[0]);
+            properties[std::string(values[1])] = bj::to_int(values[2]);
+            properties[std::string(values[3])] = bj::to_int(values[4]);
+            properties[std::string(values[5])] = bj::to_int(values[6]);
         }
     };
 
@@ -1,7 +1,6 @@
 #include "../advent_of_code.hpp"
 #include "../util/position.hpp"
 #include "../util/game_of_life.hpp"
-#include <map>
 
 // https://adventofcode.com/2015/day/18
 
@@ -19,6 +18,10 @@ namespace {
                 && position.x < grid_size && position.y < grid_size;
         }
 
+        [[nodiscard]] bj::Rectangle bounds() const noexcept {
+            return bj::Rectangle(0, 0, grid_size - 1, grid_size - 1);
+        }
+
         [[nodiscard]] bool is_on(const Element &, const bool was_on, const size_t c) const noexcept {
             if (was_on) {
                 return c == 2 || c == 3;
@@ -41,6 +44,10 @@ namespace {
                 && position.x < grid_size && position.y < grid_size;
         }
 
+        [[nodiscard]] bj::Rectangle bounds() const noexcept {
+            return bj::Rectangle(0, 0, grid_size - 1, grid_size - 1);
+        }
+
         [[nodiscard]] bool is_on(const bj::Position & position, const bool was_on, const size_t c) const noexcept {
             if (is_coin(position)) return true;
 
@@ -1,9 +1,8 @@
 #include "../advent_of_code.hpp"
+#include "../util/search.hpp"
 
+#include <memory_resource>
 #include <set>
-#include <stack>
-#include <unordered_map>
-#include <queue>
 
 // https://adventofcode.com/2015/day/19
 
@@ -32,18 +31,18 @@ namespace {
          * Build the range of words that can be reached from word with one
          * application of this rule
          */
-        WordRange map_to_constructible(const std::string & word) const;
+        WordRange map_to_constructible(std::string_view word) const;
     };
 
     /** Iterator on words generated by a rule */
     struct RuleIterator {
-        const std::string & word;
+        std::string_view word;
         const Rule & rule;
         std::optional<std::string> current;
         size_t cursor;
 
         /** Build begin() */
-        RuleIterator(const std::string & word, const Rule & rule) :
+        RuleIterator(std::string_view word, const Rule & rule) :
         word(word), rule(rule) {
             cursor = 0;
             // Begin must point on first element
@@ -51,7 +50,7 @@ namespace {
         }
 
         /** Build end() */
-        RuleIterator(const std::string & word, const Rule & rule, bool) :
+        RuleIterator(std::string_view word, const Rule & rule, bool) :
         word(word), rule(rule) {
             cursor = 0;
             current = std::nullopt;
@@ -66,7 +65,9 @@ namespace {
             } else {
                 // Move to new_position
                 cursor = new_position + 1;
-                current = word.substr(0, new_position) + rule.to + word.substr(new_position + rule.from.length());
+                current = std::string(word.substr(0, new_position));
+                current->append(rule.to);
+                current->append(word.substr(new_position + rule.from.length()));
             }
 
             return *this;
@@ -83,14 +84,14 @@ namespace {
 
     /** A range of word builded by a rule */
     struct WordRange {
-        const std::string & word;
+        std::string_view word;
         const Rule & rule;
 
         RuleIterator begin() const { return RuleIterator(word, rule); }
         RuleIterator end()   const { return RuleIterator(word, rule, false); }
     };
 
-    WordRange Rule::map_to_constructible(const std::string & word) const {
+    WordRange Rule::map_to_constructible(std::string_view word) const {
         return WordRange { word, *this };
     }
 
@@ -117,64 +118,37 @@ namespace {
         return words.size();
     }
 
-    // Shorter words are greater than longer
-    struct ShortestWordsLast {
-        bool operator()(const std::string & lhs, const std::string & rhs) const {
-            if (lhs.size() < rhs.size()) {
-                return false;
-            } else if (lhs.size() > rhs.size()) {
-                return true;
-            } else {
-                return lhs < rhs;
-            }
-        }
-    };
-
     [[nodiscard]] static std::optional<size_t> length_to_build(
         const std::string & initial_word, const std::string & final_word,
-        std::vector<Rule> rules) {
-        if (initial_word == final_word) return 0;
-
+        const std::vector<Rule> & rules, std::pmr::memory_resource * memory_resource) {
         // Revert the rule to be able to converge to e instead of diverge to maybe searched
-        std::vector<Rule> reversed_rules = revert_rules(rules);
-
-        // Structures
-        std::unordered_map<std::string, size_t> steps_to_reach;
-        std::priority_queue<std::string, std::vector<std::string>, ShortestWordsLast> wordsToExplore;
-
-        // Base case: the final word (yes)
-        steps_to_reach[final_word] = 0;
-        wordsToExplore.push(final_word);
-
-        while (!wordsToExplore.empty()) {
-            // A new candidate
-            const std::string w = wordsToExplore.top();
-            const auto my_steps = steps_to_reach[w];
-            wordsToExplore.pop();
-
-            // Apply each rule
-            for (const Rule & rule : reversed_rules) {
-                // Find every possible substitution
-                for (const auto new_word : rule.map_to_constructible(w)) {
-                    if (new_word == initial_word) {
-                        return my_steps + 1;
-                    }
-
-                    const auto itExplored = steps_to_reach.find(new_word);
-                    if (itExplored == steps_to_reach.end() || itExplored->second > my_steps + 1) {
-                        steps_to_reach[new_word] = my_steps + 1;
-                        wordsToExplore.push(new_word);
+        const std::vector<Rule> reversed_rules = revert_rules(rules);
+
+        // Greedy search: the shortest words are explored first, the number
+        // of steps only breaks the ties
+        constexpr size_t Length_Weight = 1'000'000;
+
+        const auto found = bj::search::a_star(
+            final_word,
+            [](const std::string & word) { return word; },
+            [&](const std::string & word, auto && emit) {
+                for (const Rule & rule : reversed_rules) {
+                    for (const std::string & generated_word : rule.map_to_constructible(word)) {
+                        emit(generated_word, size_t(1));
                     }
                 }
-            }
-        }
-
-        // No more candidate
-        return std::nullopt;
+            },
+            [&](const std::string & word) { return word == initial_word; },
+            [&](const std::string & word) { return word.size() * Length_Weight; },
+            bj::search::Options { .memory_resource = memory_resource }
+        );
+
+        if (!found) return std::nullopt;
+        return found->cost;
     }
 }
 
-Output day_2015_19(const std::vector<std::string> & lines, const DayExtraInfo &) {
+Output day_2015_19(const std::vector<std::string> & lines, const DayExtraInfo & dei) {
     const auto [rules, initial_string] = [&]() {
         std::vector<Rule> rules;
         std::string str;
@@ -194,7 +168,7 @@ Output day_2015_19(const std::vector<std::string> & lines, const DayExtraInfo &)
     }();
 
     const auto nb_generated_from_input = find_number_of_buildable_words_from(initial_string, rules);
-    const auto path_length_from_e = length_to_build("e", initial_string, rules).value();
+    const auto path_length_from_e = length_to_build("e", initial_string, rules, dei.memory_resource).value();
 
     return Output(nb_generated_from_input, path_length_from_e);
 }
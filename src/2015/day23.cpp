@@ -4,137 +4,93 @@
 #include <cstring>
 #include <array>
 #include "../util/regex_helper.hpp"
+#include "../util/string_split.hpp"
+#include "../util/vm.hpp"
 
 // https://adventofcode.com/2015/day/23
 
 // Computer stuff
 
 namespace {
-    struct Instruction;
-
-    /** Computer's memory with 2 registers and the PC */
+    /** Computer's memory with 2 registers, and its instructions */
     struct Computer {
-        // Memory
-        std::array<int32_t, 2> memory = { 0, 0 };
-        int32_t pc = 0;
-
-        // Run
-        void run(const std::vector<Instruction> & instructions);
-
-        // Lazier access to registers
-        int32_t & operator[](uint32_t register_) {
-            return memory[register_];
-        }
-        
-        int32_t operator[](uint32_t register_) const {
-            return memory[register_];
+        /** Supported instructions types */
+        enum Opcode : std::uint8_t {
+            /** hlf r -> r /= 2 */
+            hlf,
+            /** tpl r -> r *= 3 */
+            tpl,
+            /* inc r -> ++r */
+            inc,
+            /* jmp offset -> pc += offset */
+            jmp,
+            /* jie r, offset -> jmp offset if r is even  */
+            jie,
+            /* jio r, offset -> jmp offset if r == 1 */
+            jio
+        };
+
+        static constexpr std::array<std::string_view, 6> Opcode_Names {
+            "hlf", "tpl", "inc", "jmp", "jie", "jio"
+        };
+
+        bj::vm::Registers<int32_t, 2> registers = { 0, 0 };
+
+        template <std::size_t Opcode>
+        int32_t execute(const bj::vm::Instruction & instruction) {
+            int32_t & reg = registers[instruction.reg];
+
+            if constexpr (Opcode == hlf) { reg /= 2; return 1; }
+            if constexpr (Opcode == tpl) { reg *= 3; return 1; }
+            if constexpr (Opcode == inc) { reg += 1; return 1; }
+            if constexpr (Opcode == jmp) { return instruction.arg; }
+            if constexpr (Opcode == jie) { return reg % 2 == 0 ? instruction.arg : 1; }
+            if constexpr (Opcode == jio) { return reg == 1     ? instruction.arg : 1; }
         }
     };
 
-    /** Supported instructions types */
-    enum class Type {
-        /** hlf r -> r /= 2 */
-        hlf,
-        /** tpl r -> r *= 3 */
-        tpl,
-        /* inc r -> ++r */
-        inc,
-        /* jmp offset -> pc += offset */
-        jmp,
-        /* jie r, offset -> jmp offset if r is even  */
-        jie,
-        /* jio r, offset -> jmp offset if r == 1 */
-        jio
-    };
-
     /** Instructions. Regex black magic ensures register name and offset go at the right place */
     struct Instruction {
         // Regex
         static constexpr const char * Regex_Pattern = R"(^([a-z]*) (a|b)?,? *((\+|-)[0-9]*)?$)";
 
-        // Fields (3-address style assembly)
-        Type type_;
-        int32_t register_;
-        int32_t offset_;
+        bj::vm::Instruction bytecode;
 
         // Constructing an instruction
-        explicit Instruction(const std::vector<std::string> & values);
-
-        // Running an instruction
-        void apply(Computer & computer) const;
+        explicit Instruction(bj::RegexCaptures values);
     };
     
-    Instruction::Instruction(const std::vector<std::string> & values) {
-        if (values[0] == "hlf") type_ = Type::hlf;
-        else if (values[0] == "tpl") type_ = Type::tpl;
-        else if (values[0] == "inc") type_ = Type::inc;
-        else if (values[0] == "jmp") type_ = Type::jmp;
-        else if (values[0] == "jie") type_ = Type::jie;
-        else if (values[0] == "jio") type_ = Type::jio;
-        else std::cerr << "D2015-23: unknown type " << values[0] << "\n";
-
-        if (values[1] == "") register_ = 0;
-        else register_ = values[1][0] - 'a';
-        
-        if (values[2] == "") offset_ = 0;
-        else offset_ = std::stoi(values[2]);
-    }
-
-    void Instruction::apply(Computer & computer) const {
-        switch (type_) {
-            case Type::hlf:
-                computer[register_] /= 2;
-                ++computer.pc;
-                break;
-            case Type::tpl:
-                computer[register_] *= 3;
-                ++computer.pc;
-                break;
-            case Type::inc:
-                computer[register_] += 1;
-                ++computer.pc;
-                break;
-            case Type::jmp:
-                computer.pc += offset_;
-                break;
-            case Type::jie:
-                if (computer[register_] % 2 == 0) {
-                    computer.pc += offset_;
-                } else {
-                    ++computer.pc;
-                }
-                break;
-            case Type::jio:
-                if (computer[register_] == 1) {
-                    computer.pc += offset_;
-                } else {
-                    ++computer.pc;
-                }
-                break;
+    Instruction::Instruction(bj::RegexCaptures values) {
+        const auto opcode = std::find(Computer::Opcode_Names.begin(), Computer::Opcode_Names.end(), values[0]);
+        if (opcode == Computer::Opcode_Names.end()) {
+            std::cerr << "D2015-23: unknown type " << values[0] << "\n";
+            exit(EXIT_FAILURE);
         }
-    }
 
-    // Overall execution
-    void Computer::run(const std::vector<Instruction> & instructions) {
-        const int32_t bound = static_cast<int32_t>(instructions.size());
+        bytecode.opcode = static_cast<std::uint8_t>(opcode - Computer::Opcode_Names.begin());
 
-        while (pc >= 0 && pc < bound) {
-            instructions[pc].apply(*this);
-        }
+        if (values[1].empty()) bytecode.reg = 0;
+        else bytecode.reg = static_cast<std::uint8_t>(values[1][0] - 'a');
+        
+        if (values[2].empty()) bytecode.arg = 0;
+        else bytecode.arg = bj::to_int<int32_t>(values[2]);
     }
 }
 
 Output day_2015_23(const std::vector<std::string> & lines, const DayExtraInfo & dei) {
-    const std::vector<Instruction> instructions = bj::lines_to_class_by_regex<Instruction>(lines);
+    std::vector<bj::vm::Instruction> program;
+    for (const Instruction & instruction : bj::lines_to_class_by_regex<Instruction>(lines)) {
+        program.push_back(instruction.bytecode);
+    }
 
     // Part A : just run the code
     Computer part_a;
-    part_a.run(instructions);
+    bj::vm::run(program, part_a);
 
     // Part B : register a = 1
     Computer part_b;
-    part_b[0] = 1;
-    part_b.run(instructions);
+    part_b.registers[0] = 1;
+    bj::vm::run(program, part_b);
 
-    return Output(part_a[dei.part_a_extra_param], part_b[dei.part_b_extra_param]);
+    return Output(part_a.registers[dei.part_a_extra_param], part_b.registers[dei.part_b_extra_param]);
 }
@@ -4,6 +4,7 @@
 #include <optional>
 #include <cstring>
 #include <array>
+#include "../util/branch_and_bound.hpp"
 #include "../util/regex_helper.hpp"
 
 // https://adventofcode.com/2015/day/24
@@ -29,46 +30,57 @@ namespace {
         int64_t nb_elements = 0;
         int64_t product = 1;
         int64_t sum = 0;
+        size_t next = 0;        // Values before next are chosen or skipped
     };
 
-    using Iter = std::vector<int>::const_iterator;
-
-    void find_solution(Solution & best, Solution current, Iter begin, Iter end) {
-        // Prune
-        if (best.nb_elements > 0) {
-            if (best.nb_elements < current.nb_elements)
-                return;
-
-            if (best.nb_elements == current.nb_elements
-                && best.product <= current.product)
-                return;
-        }
-
-        // Is a candidate?
-        if (current.sum == best.sum) {
-            best.product = current.product;
-            best.nb_elements = current.nb_elements;
-            return;
-        }
-
-        // Need more values
-        if (begin == end) return;
-
-        find_solution(best, current, begin + 1, end);
-
-        current.nb_elements += 1;
-        current.sum     += *begin;
-        current.product *= *begin;
-        find_solution(best, current, begin + 1, end);
+    /**
+     * The best pack is the one with the less elements, then the lowest
+     * product: both are packed in one integer, the product in the low bits.
+     *
+     * Big products saturate, so they can not overflow on the number of
+     * elements. The product of the best pack must fit in Product_Bits.
+     */
+    constexpr int Product_Bits = 48;
+    constexpr int64_t Max_Product = (int64_t(1) << Product_Bits) - 1;
+
+    [[nodiscard]] constexpr int64_t to_score(int64_t nb_elements, int64_t product) noexcept {
+        return (nb_elements << Product_Bits) | std::min(product, Max_Product);
     }
 
-    Solution find_solution(const std::vector<int> & values, int64_t target) {
-        Solution best;
-        best.sum = target;
-        Solution solution;
-
-        find_solution(best, solution, values.begin(), values.end());
-        return best;
+    int64_t find_solution(const std::vector<int> & values, int64_t target) {
+        const auto children = [&](const Solution & current, auto && emit) {
+            if (current.sum == target || current.next == values.size()) return;
+
+            const int64_t value = values[current.next];
+
+            Solution skipped = current;
+            skipped.next += 1;
+            emit(skipped);
+
+            if (current.sum + value <= target) {
+                Solution taken = current;
+                taken.next += 1;
+                taken.nb_elements += 1;
+                taken.sum     += value;
+                taken.product = std::min(taken.product * value, Max_Product);
+                emit(taken);
+            }
+        };
+
+        // The values are positive: a pack that is not complete needs at least
+        // one more element, and the product can only grow
+        const auto bound = [&](const Solution & current) {
+            const int64_t nb_elements = current.nb_elements + (current.sum == target ? 0 : 1);
+            return to_score(nb_elements, current.product);
+        };
+
+        const auto evaluate = [&](const Solution & current) -> std::optional<int64_t> {
+            if (current.sum != target) return std::nullopt;
+            return to_score(current.nb_elements, current.product);
+        };
+
+        const int64_t score = bj::branch_and_bound::minimize<int64_t>(Solution {}, children, bound, evaluate).value();
+        return score & Max_Product;
     }
 }
 
@@ -80,5 +92,5 @@ Output day_2015_24(const std::vector<std::string> & lines, const DayExtraInfo &)
     const auto solution_3 = find_solution(values, sum / 3); // 3 packs
     const auto solution_4 = find_solution(values, sum / 4); // 4 packs
 
-    return Output(solution_3.product, solution_4.product);
+    return Output(solution_3, solution_4);
 }
@@ -1,5 +1,5 @@
 #include "../advent_of_code.hpp"
-#include <set>
+#include "../util/flat_hash.hpp"
 #include <optional>
 
 // https://adventofcode.com/2016/day/1
@@ -53,14 +53,13 @@ namespace {
         int32_t x;
         int32_t y;
 
-        /* For std::set */
-        [[nodiscard]] bool operator<(const Position & other) const {
-            if (x < other.x) return true;
-            if (x > other.x) return false;
-            if (y < other.y) return true;
-            if (y > other.y) return false;
-            return false;
-        }
+        [[nodiscard]] bool operator==(const Position & other) const = default;
+
+        struct Hash {
+            [[nodiscard]] size_t operator()(const Position & p) const noexcept {
+                return bj::hash_integers(p.x, p.y);
+            }
+        };
 
         [[nodiscard]] int32_t blocks_away_from_origin() const {
             int32_t sum = 0;
@@ -72,7 +71,7 @@ namespace {
 
     /** Track the visited position to find the first visited twice (= hq) */
     struct PositionTracker {
-        std::set<Position> visited;
+        bj::FlatHashSet<Position, Position::Hash> visited;
         std::optional<Position> first_visited_twice;
 
         void operator()(Position position) {
@@ -1,5 +1,8 @@
 #include "../advent_of_code.hpp"
 #include "../util/regex_helper.hpp"
+#include "../util/string_split.hpp"
+
+#include <map>
 
 // https://adventofcode.com/2016/day/4
 
@@ -14,9 +17,9 @@ namespace {
     struct Room {
         static constexpr const char * Regex_Pattern = R"(^([a-z\-]*)-([0-9]*)\[([a-z]*)\]$)";
         
-        explicit Room(const std::vector<std::string> & values) {
+        explicit Room(bj::RegexCaptures values) {
             name = values[0];
-            sector_id = std::stoi(values[1]);
+            sector_id = bj::to_int<int32_t>(values[1]);
             checksum = values[2];
         }
 
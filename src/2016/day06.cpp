@@ -1,5 +1,6 @@
 #include "../advent_of_code.hpp"
-#include "../util/regex_helper.hpp"
+
+#include <map>
 
 // https://adventofcode.com/2016/day/6
 
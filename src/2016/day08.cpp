@@ -1,8 +1,7 @@
 #include "../advent_of_code.hpp"
+#include "../util/bit_grid.hpp"
 #include "../util/instruction_reader.hpp"
 #include <algorithm>
-#include <regex>
-#include <array>
 #include <variant>
 
 // https://adventofcode.com/2016/day/8
@@ -45,62 +44,32 @@ namespace {
     class Surface {
         static constexpr size_t WIDE = 50;
         static constexpr size_t TALL = 6;
-        std::array<bool, WIDE * TALL> m_lights;
-
-        static size_t to_index(size_t row, size_t column) {
-            row = row % TALL;
-            column = column % WIDE;
-            return row * WIDE + column;
-        }
+        bj::BitGrid m_lights { WIDE, TALL };
 
     public:
-        Surface() { m_lights.fill(false); }
-
         // Instruction visitor
 
         void operator()(DrawRect draw) {
-            for (size_t row = 0 ; row < draw.tall ; ++row) {
-                for (size_t column = 0 ; column < draw.wide ; ++column) {
-                    m_lights[to_index(row, column)] = true;
-                }
-            }
+            if (draw.wide == 0 || draw.tall == 0) return;
+            m_lights.set_rectangle(0, 0, std::min<size_t>(draw.wide, WIDE) - 1, std::min<size_t>(draw.tall, TALL) - 1);
         }
 
         void operator()(RotateRow rotate) {
-            const auto state = m_lights;
-            
-            for (size_t i = 0 ; i != WIDE ; ++i) {
-                m_lights[to_index(rotate.row, i + rotate.pixels)] = state[to_index(rotate.row, i)];
-            }
+            m_lights.rotate_row(rotate.row % TALL, rotate.pixels);
         }
 
         void operator()(RotateColumn rotate) {
-            const auto state = m_lights;
-            
-            for (size_t i = 0 ; i != TALL ; ++i) {
-                m_lights[to_index(i + rotate.pixels, rotate.column)] = state[to_index(i, rotate.column)];
-            }
+            m_lights.rotate_column(rotate.column % WIDE, rotate.pixels);
         }
 
         // Output
 
         [[nodiscard]] size_t count_lights() const noexcept {
-            return std::count(m_lights.begin(), m_lights.end(), true);
+            return m_lights.count();
         }
 
         friend std::ostream & operator<<(std::ostream & stream, const Surface & self) {
-            for (size_t i = 0 ; i != TALL ; ++i) {
-                for (size_t j = 0 ; j != WIDE ; ++j) {
-                    if (self.m_lights[to_index(i, j)]) {
-                        stream << "#";
-                    } else {
-                        stream << ".";
-                    }
-                }
-                stream << "\n";
-            }
-
-            return stream;
+            return stream << self.m_lights;
         }
     };
 }
@@ -109,19 +78,16 @@ Output day_2016_08(const std::vector<std::string> & lines, const DayExtraInfo &)
     // Convert input
     bj::InstructionReader<Instruction> converter;
 
-    converter.add_handler(
-        R"(^rect ([0-9]*)x([0-9]*)$)",
-        [](const std::vector<std::string> & values) -> Instruction { return DrawRect(std::stoi(values[0]), std::stoi(values[1])); }
+    converter.add_handler<R"(^rect ([0-9]*)x([0-9]*)$)">(
+        [](int wide, int tall) -> Instruction { return DrawRect(wide, tall); }
     );
 
-    converter.add_handler(
-        R"(^rotate row y=([0-9]*) by ([0-9]*)$)",
-        [](const std::vector<std::string> & values) -> Instruction { return RotateRow(std::stoi(values[0]), std::stoi(values[1])); }
+    converter.add_handler<R"(^rotate row y=([0-9]*) by ([0-9]*)$)">(
+        [](int row, int pixels) -> Instruction { return RotateRow(row, pixels); }
     );
 
-    converter.add_handler(
-        R"(^rotate column x=([0-9]*) by ([0-9]*)$)",
-        [](const std::vector<std::string> & values) -> Instruction { return RotateColumn(std::stoi(values[0]), std::stoi(values[1])); }
+    converter.add_handler<R"(^rotate column x=([0-9]*) by ([0-9]*)$)">(
+        [](int column, int pixels) -> Instruction { return RotateColumn(column, pixels); }
     );
 
     const auto result = converter(lines);
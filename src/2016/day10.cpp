@@ -1,7 +1,7 @@
 #include "../advent_of_code.hpp"
 #include "../util/instruction_reader.hpp"
 #include <algorithm>
-#include <regex>
+#include <map>
 #include <array>
 #include <variant>
 #include <stack>
@@ -123,20 +123,18 @@ namespace {
 Output day_2016_10(const std::vector<std::string> & lines, const DayExtraInfo &) {
     bj::InstructionReader<Instruction> ir;
 
-    ir.add_handler(
-        R"(^value ([0-9]*) goes to bot ([0-9]*)$)",
-        [](const std::vector<std::string> & values) -> Instruction {
-            return ValueAction{ std::stoi(values[0]), std::stoi(values[1]) };
+    ir.add_handler<R"(^value ([0-9]*) goes to bot ([0-9]*)$)">(
+        [](int32_t value, int32_t bot) -> Instruction {
+            return ValueAction{ value, bot };
         }
     );
 
-    ir.add_handler(
-        R"(^bot ([0-9]*) gives low to (bot|output) ([0-9]*) and high to (bot|output) ([0-9]*)$)",
-        [](const std::vector<std::string> & values) -> Instruction {
+    ir.add_handler<R"(^bot ([0-9]*) gives low to (bot|output) ([0-9]*) and high to (bot|output) ([0-9]*)$)">(
+        [](int32_t bot, std::string_view low_kind, int32_t low, std::string_view high_kind, int32_t high) -> Instruction {
             return BotAction {
-                std::stoi(values[0]),
-                values[1] == "bot", std::stoi(values[2]),
-                values[3] == "bot", std::stoi(values[4])
+                bot,
+                low_kind  == "bot", low,
+                high_kind == "bot", high
             };
         }
     );
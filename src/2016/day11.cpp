@@ -1,9 +1,9 @@
 #include "../advent_of_code.hpp"
+#include "../util/search.hpp"
 #include <cstring>
 #include <algorithm>
 #include <array>
-#include <map>
-#include <queue>
+#include <cassert>
 
 // https://adventofcode.com/2016/day/11
 
@@ -162,6 +162,20 @@ namespace {
             return false;
         }
 
+        /** The final state: every element and the elevator on the last floor */
+        [[nodiscard]] State to_final_state() const {
+            std::vector<std::vector<Element>> final_floors(floors.size());
+            for (const auto & floor : floors) {
+                final_floors.back().insert(final_floors.back().end(), floor.begin(), floor.end());
+            }
+
+            std::sort(final_floors.back().begin(), final_floors.back().end());
+
+            State final_state { std::move(final_floors) };
+            final_state.elevator_position = floors.size();
+            return final_state;
+        }
+
         [[nodiscard]] bool is_final_state() const {
             for (size_t i = 0 ; i != floors.size() - 1 ; ++i) {
                 if (!floors[i].empty()) return false;
@@ -344,61 +358,40 @@ static std::vector<std::vector<Element>> read_input(const std::vector<std::strin
 }
 
 static size_t solve(std::vector<std::vector<Element>> floors) {
-    State state = State(floors);
+    const State start = State(floors);
 
-    std::map<uint64_t, std::pair<State, size_t>> exploredStates;
-
-    std::queue<std::pair<State, size_t>> todo;
-
-    exploredStates.emplace(state.minimize(), std::pair<State, size_t>(state, 0));
-    todo.push({ state, 0 });
-
-    const auto maybe_add = [&](State state, size_t rank) -> std::optional<State> {
-        const auto it = exploredStates.find(state.minimize());
-        if (it != exploredStates.end()) { return std::nullopt; }
-        if (state.leads_to_death())     { return std::nullopt; }
-        if (state.is_final_state()) return state;
-
-        exploredStates.emplace(state.minimize(), std::pair<State, size_t>(state, rank + 1));
-        todo.push({ state, rank + 1 });
-        return std::nullopt;
+    // Moves are reversible: the same expansion works in both directions
+    const auto expand = [](const State & state, auto && emit) {
+        state.filter_each_next_state([&](State next) {
+            if (!next.leads_to_death()) emit(std::move(next));
+            return false;
+        });
     };
 
-    size_t max_seen_rank = 0;
+    const auto encode = [](const State & state) { return state.minimize(); };
 
-    while (!todo.empty()) {
-        const auto [state_, rank] = todo.front();
-        todo.pop();
-
-        if (rank > max_seen_rank) {
-            max_seen_rank = rank;
-        }
-
-        const auto it = exploredStates.find(state_.minimize());
-        const auto & state = it->second.first;
-
-
-        std::optional<State> final_state = std::nullopt;
-
-        const size_t r = rank; // Can't capture rank
-        state.filter_each_next_state(
-            [&](State state) {
-                const auto end = maybe_add(std::move(state), r);
-                if (end) {
-                    final_state = end;
-                    return true;
-                }
+    const auto distance = bj::search::bidirectional_breadth_first(
+        start, start.to_final_state(), encode, expand, expand
+    );
 
-                return false;
-            }
-        );
+#ifndef NDEBUG
+    // Debug builds check the result with a plain breadth first search, run
+    // on the thread pool: expand and encode only read the states.
+    const auto found = bj::search::breadth_first(
+        start, encode, expand,
+        [](const State & state) { return state.is_final_state(); },
+        bj::search::Options { .track_path = true, .parallel = true }
+    );
 
-        if (final_state) {
-            return rank + 1;
-        }
+    assert(found.has_value() == distance.has_value());
+    if (found) {
+        assert(found->cost == *distance);
+        assert(found->path.size() == found->cost + 1);
+        assert(found->path.front() == start && found->path.back().is_final_state());
     }
+#endif
 
-    return none;
+    return distance.value_or(none);
 }
 
 Output day_2016_11(const std::vector<std::string> & lines, const DayExtraInfo &) {
@@ -1,73 +1,36 @@
 #include "../advent_of_code.hpp"
+#include "../util/k_sum.hpp"
 
-#include <array>
-#include <unordered_set>
+#include <span>
 
 // https://adventofcode.com/2020/day/1
 
-// find_sum_two_set and find_sum_two_sorted have the same behavior
+// Part A looks for 2 numbers, part B for 3. The config can give
+// `k` and `target`, in this order, as the extra parameters of a part.
 
-static std::array<int, 2> find_sum_two_set(int target, const std::vector<int> & values) {
-    std::unordered_set<int> expected_values;
+namespace {
+    constexpr long long int Default_Target = 2020;
 
-    for (int value : values) {
-        if (expected_values.contains(target - value)) {
-            return { value , target - value };
-        }
+    long long int product_of_k_sum(const std::vector<long long int> & numbers, std::span<const int> parameters, std::size_t default_k) {
+        const std::size_t k = parameters.size() >= 1 ? static_cast<std::size_t>(parameters[0]) : default_k;
+        const long long int target = parameters.size() >= 2 ? parameters[1] : Default_Target;
 
-        expected_values.insert(value);
-    }
-
-    return { -1, -1 };
-}
-
-static std::optional<std::pair<int, int>> find_sum_two_sorted(
-    const int target,
-    std::vector<int>::iterator left,
-    std::vector<int>::iterator right
-) {
-    --right;
-
-    while (true) {
-        if (left == right) {
-            return std::nullopt;
-        }
-
-        const int sum = *left + *right;
+        const std::optional<std::vector<long long int>> terms = bj::k_sum::find(numbers, k, target);
+        if (!terms) return -1;
 
-        if (sum < target) {
-            ++left;
-        } else if (sum > target) {
-            --right;
-        } else {
-            return std::pair<int, int>(*left, *right);
-        }
+        long long int product = 1;
+        for (const long long int term : *terms) product *= term;
+        return product;
     }
 }
 
-static std::array<int, 3> find_sum_three_values(
-    const int target,
-    std::vector<int>::iterator left,
-    std::vector<int>::iterator right
-) {
-    while (left != right) {
-        if (const auto f = find_sum_two_sorted(target - *left, left + 1, right)) {
-            return std::array<int, 3>{f->first, f->second, *left};
-        }
-
-        ++left;
-    }
-
-    return { -1, -1, -1 };
-}
-
-Output day_2020_01(const std::vector<std::string> & lines, const DayExtraInfo &) {
-    std::vector<int> numbers = lines_transform::to_ints(lines);
-    
-    const auto r1 = find_sum_two_set(2020, numbers);
-
-    std::sort(numbers.begin(), numbers.end());
-    const auto r2 = find_sum_three_values(2020, numbers.begin(), numbers.end());
+Output day_2020_01(const std::vector<std::string> & lines, const DayExtraInfo & dei) {
+    const std::vector<long long int> numbers = lines_transform::map<long long int>(lines,
+        [](const std::string & line) { return std::stoll(line); }
+    );
 
-    return Output(r1[0] * r1[1], r2[0] * r2[1] * r2[2]);
+    return Output(
+        product_of_k_sum(numbers, dei.part_a_extra_params, 2),
+        product_of_k_sum(numbers, dei.part_b_extra_params, 3)
+    );
 }
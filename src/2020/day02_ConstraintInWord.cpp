@@ -1,46 +1,64 @@
 #include "../advent_of_code.hpp"
-#include <regex>
+#include "../util/isa.hpp"
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <optional>
+#include <string_view>
 
 // https://adventofcode.com/2020/day/2
 
 struct PolicyPassword {
-    size_t first;
-    size_t second;
+    std::uint32_t first;
+    std::uint32_t second;
     char key;
-    std::string password;
+    /** View on the line it was read from */
+    std::string_view password;
 
-    [[nodiscard]] static PolicyPassword from_string(const std::string & str);
+    [[nodiscard]] static std::optional<PolicyPassword> from_string(std::string_view line) noexcept;
 };
 
-PolicyPassword PolicyPassword::from_string(const std::string & str) {
-    constexpr const char * const PATTERN = R"(^([0-9]+)-([0-9]+) ([a-zA-Z]): ([a-z0-9A-Z]*)$)";
-    std::regex pattern { PATTERN };
+// A line is "first-second key: password". It is read in one pass, without
+// allocation.
+std::optional<PolicyPassword> PolicyPassword::from_string(std::string_view line) noexcept {
+    std::size_t i = 0;
 
-    std::smatch matches;
-    const bool rs = std::regex_search(str, matches, pattern);
+    const auto read_number = [&](std::uint32_t & value) {
+        const std::size_t start = i;
+        value = 0;
+        while (i < line.size() && line[i] >= '0' && line[i] <= '9') {
+            value = value * 10 + static_cast<std::uint32_t>(line[i] - '0');
+            ++i;
+        }
+        return i != start;
+    };
+
+    const auto read_char = [&](char expected) {
+        if (i >= line.size() || line[i] != expected) return false;
+        ++i;
+        return true;
+    };
 
-    if (!rs) {
-        std::cerr << "Invalid line\n" << str << "\n";
-        exit(EXIT_FAILURE);
+    PolicyPassword policy;
+    if (!read_number(policy.first) || !read_char('-') || !read_number(policy.second) || !read_char(' ')) {
+        return std::nullopt;
     }
 
-    return PolicyPassword {
-        .first    = std::stoul(matches[1].str()),
-        .second   = std::stoul(matches[2].str()),
-        .key      = matches[3].str()[0],
-        .password = matches[4].str()
-    };
+    if (i >= line.size() || !std::isalpha(static_cast<unsigned char>(line[i]))) return std::nullopt;
+    policy.key = line[i++];
+
+    if (!read_char(':') || !read_char(' ')) return std::nullopt;
+
+    policy.password = line.substr(i);
+    return policy;
 }
 
-static bool match_ruleset1(const PolicyPassword & pp) {
-    const size_t count = std::count(
-        pp.password.begin(), pp.password.end(), pp.key
-    );
+static bool match_ruleset1(const PolicyPassword & pp, std::size_t count) {
     return count >= pp.first && count <= pp.second;
 }
 
 static bool match_ruleset2(const PolicyPassword & pp) {
-    const auto check_position = [&](const size_t position) {
+    const auto check_position = [&](const std::size_t position) {
         return position - 1 < pp.password.size()
             && pp.password[position - 1] == pp.key;
     };
@@ -48,16 +66,92 @@ static bool match_ruleset2(const PolicyPassword & pp) {
     return check_position(pp.first) ^ check_position(pp.second);
 }
 
+/**
+ * Checks the passwords by batches. The passwords of a batch are stored
+ * column by column, so the occurrences of the keys are counted on all the
+ * passwords at once, with one vector comparison per character position.
+ */
+class PasswordChecker {
+    static constexpr std::size_t Lanes      = 64;
+    /** Longer passwords are checked on their own */
+    static constexpr std::size_t Max_Length = 32;
+
+    /** m_columns[position][lane], 0 after the end of the password */
+    std::array<std::array<char, Lanes>, Max_Length> m_columns {};
+    std::array<PolicyPassword, Lanes> m_policies;
+    std::size_t m_size = 0;
+    std::size_t m_longest = 0;
+
+    int m_valid_ruleset1 = 0;
+    int m_valid_ruleset2 = 0;
+
+    void check(const PolicyPassword & policy, std::size_t count) {
+        if (match_ruleset1(policy, count)) ++m_valid_ruleset1;
+        if (match_ruleset2(policy))        ++m_valid_ruleset2;
+    }
+
+    void flush() {
+        std::array<char, Lanes> keys {};
+        for (std::size_t lane = 0 ; lane != m_size ; ++lane) keys[lane] = m_policies[lane].key;
+
+        std::array<std::uint8_t, Lanes> counts {};
+        bj::isa::dispatch([&]() {
+            for (std::size_t position = 0 ; position != m_longest ; ++position) {
+                const std::array<char, Lanes> & column = m_columns[position];
+                for (std::size_t lane = 0 ; lane != Lanes ; ++lane) {
+                    counts[lane] += column[lane] == keys[lane] ? 1 : 0;
+                }
+            }
+        });
+
+        for (std::size_t lane = 0 ; lane != m_size ; ++lane) check(m_policies[lane], counts[lane]);
+
+        for (std::size_t position = 0 ; position != m_longest ; ++position) m_columns[position].fill(0);
+        m_size = 0;
+        m_longest = 0;
+    }
+
+public:
+    void add(const PolicyPassword & policy) {
+        const std::string_view password = policy.password;
+
+        if (password.size() > Max_Length) {
+            std::size_t count = 0;
+            for (const char c : password) count += c == policy.key ? 1 : 0;
+            check(policy, count);
+            return;
+        }
+
+        for (std::size_t position = 0 ; position != password.size() ; ++position) {
+            m_columns[position][m_size] = password[position];
+        }
+
+        m_policies[m_size] = policy;
+        m_longest = std::max(m_longest, password.size());
+        if (++m_size == Lanes) flush();
+    }
+
+    /** Number of valid passwords for both rulesets */
+    [[nodiscard]] std::pair<int, int> result() {
+        if (m_size != 0) flush();
+        return { m_valid_ruleset1, m_valid_ruleset2 };
+    }
+};
+
 Output day_2020_02(const std::vector<std::string> & lines, const DayExtraInfo &) {
-    const std::vector<PolicyPassword> policies = 
-        lines_transform::map<PolicyPassword>(lines, PolicyPassword::from_string);
+    PasswordChecker checker;
 
-    constexpr auto count_valid = [](const auto & policies, auto predicate) {
-        return static_cast<int>(std::count_if(policies.begin(), policies.end(), predicate));
-    };
+    for (const std::string & line : lines) {
+        const std::optional<PolicyPassword> policy = PolicyPassword::from_string(line);
+
+        if (!policy) {
+            std::cerr << "Invalid line\n" << line << "\n";
+            exit(EXIT_FAILURE);
+        }
 
-    const int ruleset1 = count_valid(policies, match_ruleset1);
-    const int ruleset2 = count_valid(policies, match_ruleset2);
+        checker.add(*policy);
+    }
 
+    const auto [ruleset1, ruleset2] = checker.result();
     return Output(ruleset1, ruleset2);
 }
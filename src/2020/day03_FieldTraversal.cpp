@@ -1,36 +1,100 @@
 #include "../advent_of_code.hpp"
-#include <regex>
+#include "../util/bit_grid.hpp"
+#include <span>
 
 // https://adventofcode.com/2020/day/3
 
 constexpr char TREE = '#';
 
-static auto count_trees_on_slope(Board board, size_t x, size_t y, int dX, int dY) {
-    long long int count = 0;
+struct Slope {
+    size_t right;
+    size_t down;
+};
 
-    BoardPosition pos = BoardPosition(board, x, y, true, false);
+/**
+ * Slopes given as right`down pairs in the extra parameters, or the default
+ * ones if there are none
+ */
+static std::vector<Slope> read_slopes(std::span<const int> params, std::vector<Slope> defaults) {
+    if (params.empty()) return defaults;
 
-    while (auto something = *pos) {
-        if (*something == TREE) {
-            ++count;
+    if (params.size() % 2 != 0) {
+        std::cerr << "2020-03: the slopes must be given as right`down pairs\n";
+        exit(EXIT_FAILURE);
+    }
+
+    std::vector<Slope> slopes;
+    for (size_t i = 0 ; i != params.size() ; i += 2) {
+        if (params[i] < 0 || params[i + 1] <= 0) {
+            std::cerr << "2020-03: invalid slope " << params[i] << "`" << params[i + 1] << "\n";
+            exit(EXIT_FAILURE);
         }
 
-        pos.offset(dX, dY);
+        slopes.push_back(Slope { static_cast<size_t>(params[i]), static_cast<size_t>(params[i + 1]) });
+    }
+
+    return slopes;
+}
+
+static bj::BitGrid read_forest(const std::vector<std::string> & lines) {
+    const size_t width = lines.empty() ? 0 : lines[0].size();
+    bj::BitGrid forest(width, lines.size());
+
+    for (size_t y = 0 ; y != lines.size() ; ++y) {
+        forest.set_row(y, lines[y], TREE);
     }
 
-    return count;
+    return forest;
 }
 
-Output day_2020_03(const std::vector<std::string> & lines, const DayExtraInfo &) {
-    Board board = Board(lines);
+/**
+ * Number of trees met on every slope. The rows are read once, from top to
+ * bottom, and each slope remembers the next row it visits and its column
+ * on that row.
+ */
+static std::vector<long long int> count_trees(const bj::BitGrid & forest, const std::vector<Slope> & slopes) {
+    std::vector<long long int> trees(slopes.size(), 0);
+    if (forest.width() == 0) return trees;
+
+    std::vector<size_t> next_rows(slopes.size(), 0);
+    std::vector<size_t> columns(slopes.size(), 0);
+    std::vector<size_t> rights;
+    for (const Slope & slope : slopes) rights.push_back(slope.right % forest.width());
+
+    for (size_t y = 0 ; y != forest.height() ; ++y) {
+        for (size_t s = 0 ; s != slopes.size() ; ++s) {
+            if (next_rows[s] != y) continue;
+            next_rows[s] += slopes[s].down;
+
+            if (forest.get(columns[s], y)) ++trees[s];
+
+            columns[s] += rights[s];
+            if (columns[s] >= forest.width()) columns[s] -= forest.width();
+        }
+    }
+
+    return trees;
+}
+
+Output day_2020_03(const std::vector<std::string> & lines, const DayExtraInfo & dei) {
+    const bj::BitGrid forest = read_forest(lines);
+
+    // The slope of part A is counted with the others
+    std::vector<Slope> slopes = read_slopes(dei.part_a_extra_params, { Slope { 3, 1 } });
+    if (slopes.size() != 1) {
+        std::cerr << "2020-03: part A has one slope\n";
+        exit(EXIT_FAILURE);
+    }
+
+    const std::vector<Slope> part_b_slopes = read_slopes(dei.part_b_extra_params,
+        { Slope { 1, 1 }, Slope { 3, 1 }, Slope { 5, 1 }, Slope { 7, 1 }, Slope { 1, 2 } }
+    );
+    slopes.insert(slopes.end(), part_b_slopes.begin(), part_b_slopes.end());
 
-    const auto slope_1_1 = count_trees_on_slope(board, 0, 0, 1, 1);
-    const auto slope_3_1 = count_trees_on_slope(board, 0, 0, 3, 1);
-    const auto slope_5_1 = count_trees_on_slope(board, 0, 0, 5, 1);
-    const auto slope_7_1 = count_trees_on_slope(board, 0, 0, 7, 1);
-    const auto slope_1_2 = count_trees_on_slope(board, 0, 0, 1, 2);
+    const std::vector<long long int> trees = count_trees(forest, slopes);
 
-    const auto times = slope_1_1 * slope_3_1 * slope_5_1 * slope_7_1 * slope_1_2;
+    long long int times = 1;
+    for (size_t s = 1 ; s != trees.size() ; ++s) times *= trees[s];
 
-    return Output(slope_3_1 , times);
+    return Output(trees[0], times);
 }
@@ -2,12 +2,13 @@
 #include "../libs_ensemblist.hpp"
 
 #include <numeric>
-#include <set>
 
 // https://adventofcode.com/2020/day/6
 
-static std::set<char> to_set(const std::string & x) {
-    std::set<char> retval;
+using Answers = set::DenseSet<char>;
+
+static Answers to_set(const std::string & x) {
+    Answers retval;
     for (char xx : x) {
         retval.insert(xx);
     }
@@ -17,15 +18,18 @@ static std::set<char> to_set(const std::string & x) {
 Output day_2020_06(const std::vector<std::string> & lines, const DayExtraInfo &) {
     const auto compute = [&](auto reducer) {
         const std::vector<size_t> per_group =
-            lines_transform::group<size_t, std::set<char>>(
+            lines_transform::group<size_t, Answers>(
                 lines,
-                to_set,     // string -> std::set<char>
-                reducer,    // 2 std::set<char> -> 1 std::set<char>
-                [](const std::set<char> & m) { return m.size(); } // std::set::size
+                to_set,     // string -> Answers
+                reducer,    // 2 Answers -> 1 Answers
+                [](const Answers & m) { return m.size(); } // popcount
             );
 
         return std::accumulate(per_group.begin(), per_group.end(), 0);
     };
 
-    return Output(compute(set::union_<char>), compute(set::intersection<char>));
+    return Output(
+        compute([](const Answers & lhs, const Answers & rhs) { return set::union_(lhs, rhs); }),
+        compute([](const Answers & lhs, const Answers & rhs) { return set::intersection(lhs, rhs); })
+    );
 }
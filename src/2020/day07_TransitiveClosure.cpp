@@ -1,4 +1,5 @@
 #include "../advent_of_code.hpp"
+#include "../util/symbol_table.hpp"
 #include <regex>
 
 // https://adventofcode.com/2020/day/7
@@ -18,14 +19,14 @@ struct NamedBag;
 
 class Bag {
 public:
-    using All     = std::map<std::string, Bag>;
-    using Content = std::map<std::string, unsigned int>;
+    using All     = bj::SymbolVector<Bag>;
+    using Content = std::map<bj::SymbolId, unsigned int>;
 private:
     Content m_contained_bags;
     bool is_transitively_closed = false;
 
 public:
-    static NamedBag New(std::string line, std::regex & regex_contain, std::regex & regex_contained);
+    static NamedBag New(std::string line, std::regex & regex_contain, std::regex & regex_contained, bj::SymbolTable & names);
 
     Bag() = default;
     explicit Bag(Content content) : m_contained_bags(std::move(content)) {}
@@ -42,45 +43,44 @@ public:
         return total;
     }
 
-    [[nodiscard]] unsigned int get_number_of(const std::string & bag_name) const noexcept {
+    [[nodiscard]] unsigned int get_number_of(bj::SymbolId bag_name) const noexcept {
         const auto it = m_contained_bags.find(bag_name);
         if (it == m_contained_bags.end()) return 0;
         return it->second;
     }
 
-    friend std::ostream & operator<<(std::ostream & stream, const Bag::All & all);
+    friend void print_bags(std::ostream & stream, const Bag::All & all, const bj::SymbolTable & names);
 };
 
-std::ostream & operator<<(std::ostream & stream, const Bag::All & all) {
-    for (const auto & [name, bag] : all) {
+void print_bags(std::ostream & stream, const Bag::All & all, const bj::SymbolTable & names) {
+    for (bj::SymbolId name = 0 ; name != all.size() ; ++name) {
+        const Bag & bag = all[name];
 
         stream << (bag.is_transitively_closed ? "CLOSED " : " OPEN  ")
-               << name << ": ";
+               << names.name(name) << ": ";
 
         for (const auto & [nameContained, quantity] : bag.m_contained_bags) {
-            stream << quantity << ' ' << nameContained << " / ";
+            stream << quantity << ' ' << names.name(nameContained) << " / ";
         }
 
         stream << '\n';
     }
-
-    return stream;
 }
 
-struct NamedBag { std::string name; Bag bag; };
+struct NamedBag { bj::SymbolId name; Bag bag; };
 
 
-NamedBag Bag::New(std::string line, std::regex & regex_contain, std::regex & regex_contained) {
+NamedBag Bag::New(std::string line, std::regex & regex_contain, std::regex & regex_contained, bj::SymbolTable & names) {
     std::smatch matches;
 
     std::regex_search(line, matches, regex_contain);
-    std::string this_bag_name = matches[1].str();
+    const bj::SymbolId this_bag_name = names.intern(matches[1].str());
     std::string content = matches[2].str();
     
     Bag::Content bag_content;
     while (std::regex_search(content, matches, regex_contained)) {
         unsigned int quantity = std::stoul(matches[1].str());
-        std::string name = matches[2].str();
+        const bj::SymbolId name = names.intern(matches[2].str());
 
         bag_content[name] += quantity;
 
@@ -93,17 +93,15 @@ NamedBag Bag::New(std::string line, std::regex & regex_contain, std::regex & reg
 void Bag::ensure_is_transitively_closed(Bag::All & all_bags) {
     if (is_transitively_closed) return;
 
-    std::map<std::string, unsigned int> closure;
+    Content closure;
 
     for (const auto & [bag_name, quantity] : m_contained_bags) {
         closure[bag_name] += quantity;
 
-        const auto itContainedBag = all_bags.find(bag_name);
-        if (itContainedBag == all_bags.end()) continue;
-
-        itContainedBag->second.ensure_is_transitively_closed(all_bags);
+        Bag & contained_bag = all_bags[bag_name];
+        contained_bag.ensure_is_transitively_closed(all_bags);
 
-        for (const auto & [bag_in_bag_name, bag_in_bag_quantity] : itContainedBag->second.m_contained_bags) {
+        for (const auto & [bag_in_bag_name, bag_in_bag_quantity] : contained_bag.m_contained_bags) {
             closure[bag_in_bag_name] += bag_in_bag_quantity * quantity;
         }
     }
@@ -117,8 +115,11 @@ Output day_2020_07(const std::vector<std::string> & lines, const DayExtraInfo &)
     std::regex regex_bag_contains { BAGS_CONTAIN };
     std::regex regex_contained   { CONTAINED_BAG };
 
+    bj::SymbolTable names;
+    const bj::SymbolId shiny_gold = names.intern("shiny gold");
+
     const auto bag_map = [&](const std::string & line) {
-        return Bag::New(line, regex_bag_contains, regex_contained);
+        return Bag::New(line, regex_bag_contains, regex_contained, names);
     };
 
     Bag::All all_bags;
@@ -126,19 +127,22 @@ Output day_2020_07(const std::vector<std::string> & lines, const DayExtraInfo &)
         all_bags[named_bag.name] = std::move(named_bag.bag);
     }
 
-    for (auto & [_name, bag] : all_bags) {
-        bag.ensure_is_transitively_closed(all_bags);
+    // Bags that are only contained have no rule: they are empty
+    all_bags.resize(names.size());
+
+    for (bj::SymbolId name = 0 ; name != all_bags.size() ; ++name) {
+        all_bags[name].ensure_is_transitively_closed(all_bags);
     }
 
-    // std::cout << all_bags;
+    // print_bags(std::cout, all_bags, names);
 
     unsigned int shiny_gold_containers = 0;
 
-    for (auto & [_name, bag] : all_bags) {
-        if (bag.get_number_of("shiny gold") > 0) {
+    for (const Bag & bag : all_bags) {
+        if (bag.get_number_of(shiny_gold) > 0) {
             ++shiny_gold_containers;
         }
     }
 
-    return Output(shiny_gold_containers, all_bags["shiny gold"].get_number_of_bags());
+    return Output(shiny_gold_containers, all_bags[shiny_gold].get_number_of_bags());
 }
@@ -1,99 +1,66 @@
 #include "../advent_of_code.hpp"
+#include "../util/vm.hpp"
 
 // https://adventofcode.com/2020/day/8
 
-enum class InstructionType {
-    Nop, Acc, Jmp
-};
+namespace {
+    struct Console {
+        enum Opcode : std::uint8_t { Nop, Acc, Jmp };
 
-static InstructionType invert_of(InstructionType type) {
-    switch (type) {
-        case InstructionType::Nop: return InstructionType::Jmp;
-        case InstructionType::Jmp: return InstructionType::Nop;
-        case InstructionType::Acc: return InstructionType::Acc;
-        default: return InstructionType::Acc;
-    }
-}
-
-struct Instruction {
-    InstructionType type;
-    int value;
+        static constexpr std::array<std::string_view, 3> Opcode_Names { "nop", "acc", "jmp" };
 
-    static Instruction from_string(const std::string & s) {
-        const std::string type = s.substr(0, 3);
-        const int value = std::stoi(s.substr(4));
+        bj::vm::Registers<int, 1> accumulator = { 0 };
 
-        if (type == "acc") {
-            return { InstructionType::Acc, value };
-        } else if (type == "jmp") {
-            return { InstructionType::Jmp, value };
-        } else {
-            if (type != "nop") { std::cerr << "Invalid instruction " << type << '\n'; }
-
-            return { InstructionType::Nop, value };
+        template <std::size_t Opcode>
+        std::int32_t execute(const bj::vm::Instruction & instruction) {
+            if constexpr (Opcode == Nop) { return 1; }
+            if constexpr (Opcode == Acc) { accumulator[0] += instruction.arg; return 1; }
+            if constexpr (Opcode == Jmp) { return instruction.arg; }
         }
-    }
-};
 
-class Computer {
-    size_t m_pc = 0;
-    int m_register = 0;
-    const std::vector<Instruction> * m_program;
-    std::vector<bool> m_already_visited_lines;
+        static bj::vm::Instruction from_string(const std::string & s) {
+            const std::string_view type = std::string_view(s).substr(0, 3);
+            const int value = std::stoi(s.substr(4));
 
-public:
-    explicit Computer(const std::vector<Instruction> & program)
-    : m_program(&program), m_already_visited_lines(program.size(), false) {}
+            if (type == "acc") {
+                return { Acc, 0, value };
+            } else if (type == "jmp") {
+                return { Jmp, 0, value };
+            } else {
+                if (type != "nop") { std::cerr << "Invalid instruction " << type << '\n'; }
 
-    bool is_on_valid_instruction() const {
-        return !pc_is_out_of_memory() && !m_already_visited_lines[m_pc];
-    }
-
-    [[nodiscard]] bool pc_is_out_of_memory() const noexcept { return m_pc >= m_program->size(); }
-    [[nodiscard]] bool pc_is_at_end()        const noexcept { return m_pc == m_program->size(); }
-    
-    void run() {
-        const auto & instruction = (*m_program)[m_pc];
-        m_already_visited_lines[m_pc] = true;
-
-        switch (instruction.type) {
-            case InstructionType::Nop:
-                ++m_pc;
-                break;
-            case InstructionType::Acc:
-                ++m_pc;
-                m_register += instruction.value;
-                break;
-            case InstructionType::Jmp:
-                m_pc += instruction.value;
-                break;
+                return { Nop, 0, value };
+            }
         }
-    }
 
-    [[nodiscard]] int register_value() const noexcept { return m_register; }
-
-    static std::pair<bool, int> compute(const std::vector<Instruction> & program) {
-        Computer computer = Computer(program);
-
-        while (computer.is_on_valid_instruction()) {
-            computer.run();
+        /** Runs the program until it loops or ends. Returns if it ended and the accumulator */
+        static std::pair<bool, int> compute(const std::vector<bj::vm::Instruction> & program) {
+            Console console;
+            const bj::vm::RunResult result = bj::vm::run(program, console, bj::vm::Options { .detect_loops = true });
+            return std::pair<bool, int>(result.ended_normally(program.size()), console.accumulator[0]);
         }
+    };
 
-        return std::pair<bool, int>(computer.pc_is_at_end(), computer.register_value());
+    std::uint8_t invert_of(std::uint8_t opcode) {
+        switch (opcode) {
+            case Console::Nop: return Console::Jmp;
+            case Console::Jmp: return Console::Nop;
+            default:           return opcode;
+        }
     }
-};
+}
 
 Output day_2020_08(const std::vector<std::string> & lines, const DayExtraInfo &) {
-    std::vector<Instruction> instructions = lines_transform::map<Instruction>(lines, Instruction::from_string);
+    std::vector<bj::vm::Instruction> instructions = lines_transform::map<bj::vm::Instruction>(lines, Console::from_string);
 
-    const auto [_1, accumulator_loop] = Computer::compute(instructions);
+    const auto [_1, accumulator_loop] = Console::compute(instructions);
 
     int accumulator_decorrupted = -1;
-    for (Instruction & instruction : instructions) {
-        if (instruction.type != invert_of(instruction.type)) {
-            instruction.type = invert_of(instruction.type);
-            const auto [good_end, accumulator] = Computer::compute(instructions);
-            instruction.type = invert_of(instruction.type);
+    for (bj::vm::Instruction & instruction : instructions) {
+        if (instruction.opcode != invert_of(instruction.opcode)) {
+            instruction.opcode = invert_of(instruction.opcode);
+            const auto [good_end, accumulator] = Console::compute(instructions);
+            instruction.opcode = invert_of(instruction.opcode);
             
             if (good_end) {
                 accumulator_decorrupted = accumulator;
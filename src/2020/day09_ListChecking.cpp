@@ -1,4 +1,5 @@
 #include "../advent_of_code.hpp"
+#include "../util/flat_hash.hpp"
 
 // https://adventofcode.com/2020/day/9
 
@@ -7,63 +8,78 @@ using UUINT = long long unsigned int;
 using Values = std::vector<UUINT>;
 using ValuesIter = Values::const_iterator;
 
-static bool is_sum_of_two_in(ValuesIter begin, ValuesIter end, UUINT value) {
-    for (auto it = begin; it != end; ++it) {
-        for (auto it2 = begin; it2 != end; ++it2) {
-            if (it == it2) continue;
-
-            if (*it + *it2 == value) return true;
+/** The last values of the stream, counted in a hash map */
+class Window {
+    bj::FlatHashMap<UUINT, unsigned int> m_count;
+
+public:
+    void add(UUINT value)    { ++m_count[value]; }
+    void remove(UUINT value) { if (--m_count[value] == 0) m_count.erase(value); }
+
+    /** True if the value is the sum of two different values of the window */
+    [[nodiscard]] bool is_sum_of_two(UUINT value) const {
+        for (const auto & [term, count] : m_count) {
+            if (term > value) continue;
+
+            const UUINT other = value - term;
+            if (other == term) {
+                if (count >= 2) return true;
+            } else if (m_count.contains(other)) {
+                return true;
+            }
         }
-    }
 
-    return false;
-}
+        return false;
+    }
+};
 
 static size_t find_invalid(const Values & values, const size_t preambule) {
-    // Sliding window
-    auto window_begin = values.begin();
-    auto window_end = values.begin() + preambule;
+    // Sliding window, updated in O(1) for each new value
+    Window window;
+    for (size_t i = 0 ; i != preambule && i != values.size() ; ++i) {
+        window.add(values[i]);
+    }
 
-    while (window_end != values.end()) {
-        if (!is_sum_of_two_in(window_begin, window_end, *window_end)) {
-            return window_end - values.begin();
-        }
+    for (size_t i = preambule ; i < values.size() ; ++i) {
+        if (!window.is_sum_of_two(values[i])) return i;
 
-        ++window_begin;
-        ++window_end;
+        window.add(values[i]);
+        window.remove(values[i - preambule]);
     }
 
     return values.size();
 }
 
+/** The numbers are positive: a two pointers sweep finds the range in O(n) */
 static std::pair<ValuesIter, ValuesIter> get_contiguous_sum(const Values & values, const UUINT target) {
-    ValuesIter it = values.begin();
-
-    while (it != values.end()) {
-        UUINT current_sum = 0;
+    ValuesIter begin = values.begin();
+    ValuesIter end = values.begin();
+    UUINT current_sum = 0;
 
-        ValuesIter end = it;
+    while (true) {
+        if (current_sum == target && end - begin >= 2) {
+            return std::pair(begin, end);
+        }
 
-        while (end != values.end() && current_sum < target) {
+        if (current_sum <= target && end != values.end()) {
             current_sum += *end;
             ++end;
+        } else if (begin != end) {
+            current_sum -= *begin;
+            ++begin;
+        } else {
+            return std::pair(values.end(), values.end());
         }
-
-        if (target == current_sum) {
-            return std::pair(it, end);
-        }
-
-        ++it;
     }
-
-    return std::pair(values.end(), values.end());
 }
 
-Output day_2020_09(const std::vector<std::string> & lines, const DayExtraInfo &) {
+Output day_2020_09(const std::vector<std::string> & lines, const DayExtraInfo & dei) {
     const std::vector<UUINT> values = lines_transform::map<UUINT>(lines,
         [](const std::string & s) { return std::stoull(s); }
     );
-    const size_t preambule_size = values.size() == 20 ? 5 : 25;
+
+    // The preambule is given in the configuration, 25 by default
+    const size_t preambule_size = dei.part_a_extra_param != 0 ? static_cast<size_t>(dei.part_a_extra_param) : 25;
 
     // Find number that is not the sum of the preambule_size previous elements
     const size_t position_of_invalid = find_invalid(values, preambule_size);
@@ -1,18 +1,16 @@
 #include "../advent_of_code.hpp"
+#include "../util/stencil.hpp"
+#include "../util/tiled_stepper.hpp"
 
 // https://adventofcode.com/2020/day/11
 
 
-static unsigned int count_empty_seats(Board board) {
+static unsigned int count_empty_seats(const Board & board) {
     unsigned int counter = 0;
 
-    for (size_t x = 0 ; x != board.width() ; ++x) {
-        for (size_t y = 0 ; y != board.height() ; ++y) {
-            const auto c = board.get_at(x, y);
-            if (*c == '#') {
-                ++counter;
-            }
-        }
+    for (size_t y = 0 ; y != board.height() ; ++y) {
+        const char * row = board.row(y);
+        counter += std::count(row, row + board.width(), '#');
     }
 
     return counter;
@@ -22,16 +20,10 @@ static char around(char current_char, const Board & board, size_t x, size_t y) {
     // count occupied
     unsigned int occupied = 0;
 
-    for (size_t xprime : { x - 1, x, x + 1 }) {
-        for (size_t yprime : { y - 1, y, y + 1 }) {
-            if (xprime == x && yprime == y) continue;
-
-            if (const auto opt_char = board.get_at(xprime, yprime)) {
-                // opt_char == std::nullopt if out of bound
-                if (*opt_char == '#') {
-                    ++occupied;
-                }
-            }
+    for (const auto & [x_delta, y_delta] : bj::stencil::moore<2>) {
+        // The border of the board is never occupied
+        if (board.at(x + x_delta, y + y_delta) == '#') {
+            ++occupied;
         }
     }
 
@@ -46,25 +38,20 @@ static char around(char current_char, const Board & board, size_t x, size_t y) {
 static char line_vision(char current_char, const Board & board, const size_t x, const size_t y) {
     unsigned int occupied = 0;
 
-    for (    int x_delta : { -1, 0, 1 }) {
-        for (int y_delta : { -1, 0, 1 }) {
-            if (x_delta == 0 && y_delta == 0) continue;
-
-            size_t xp = x;
-            size_t yp = y;
+    for (const auto & [x_delta, y_delta] : bj::stencil::moore<2>) {
+        size_t xp = x;
+        size_t yp = y;
 
-            while (true) {
-                xp += x_delta;
-                yp += y_delta;
+        while (true) {
+            xp += x_delta;
+            yp += y_delta;
 
-                const auto opt_char = board.get_at(xp, yp);
+            // The border stops the vision before leaving the board
+            const char c = board.at(xp, yp);
 
-                if (!opt_char) break;
-
-                if (*opt_char != '.') {
-                    if (*opt_char == '#') ++occupied;
-                    break;
-                }
+            if (c != '.') {
+                if (c == '#') ++occupied;
+                break;
             }
         }
     }
@@ -76,33 +63,48 @@ static char line_vision(char current_char, const Board & board, const size_t x,
     }
 }
 
+/**
+ * Runs the seat rule until the seats are stable. A local rule only looks at
+ * the direct neighbours, so the stable regions of the board can be skipped.
+ */
 template <typename Function>
-unsigned int figure_empty_seats(Board board, Function slot_changer) {
-    while (true) {
-        Board new_board = board;
+unsigned int figure_empty_seats(Board board, Function slot_changer, bool is_local) {
+    // Double buffer: the floor never changes so every generation rewrites
+    // all the seats of new_board.
+    Board new_board = board;
+    bj::TiledStepper stepper(board.width(), board.height(), is_local);
+
+    const auto compute_tile = [&](const bj::TiledStepper::Tile & tile) {
+        bool changed = false;
 
-        for (size_t x = 0 ; x != board.width() ; ++x) {
-            for (size_t y = 0 ; y != board.height() ; ++y) {
-                const char current_symbol = *board.get_at(x, y);
+        for (size_t y = tile.top ; y != tile.bottom ; ++y) {
+            const char * row = board.row(y);
+            char * new_row = new_board.row(y);
+
+            for (size_t x = tile.left ; x != tile.right ; ++x) {
+                const char current_symbol = row[x];
                 if (current_symbol != '.') {
-                    new_board.set_at(x, y, slot_changer(current_symbol, board, x, y));
+                    new_row[x] = slot_changer(current_symbol, board, x, y);
+                    changed |= new_row[x] != current_symbol;
                 }
             }
         }
 
-        if (new_board == board) {
-            return count_empty_seats(board);
-        }
+        return changed;
+    };
 
-        board = new_board;
+    while (stepper.step(compute_tile)) {
+        board.swap(new_board);
     }
+
+    return count_empty_seats(board);
 }
 
 Output day_2020_11(const std::vector<std::string> & lines, const DayExtraInfo &) {
     Board board = Board(lines);
 
-    const unsigned int empty_seats_A = figure_empty_seats(board, around);
-    const unsigned int empty_seats_B = figure_empty_seats(board, line_vision);
+    const unsigned int empty_seats_A = figure_empty_seats(board, around, true);
+    const unsigned int empty_seats_B = figure_empty_seats(board, line_vision, false);
 
     return Output(empty_seats_A, empty_seats_B);
 }
@@ -1,4 +1,5 @@
 #include "../advent_of_code.hpp"
+#include "../util/string_split.hpp"
 #include <algorithm>
 
 // https://adventofcode.com/2020/day/13
@@ -24,12 +25,10 @@ struct Bus {
 static std::vector<Bus> read_buses(std::string_view line) {
     std::vector<Bus> buses;
 
-    StringSplitter splitter = StringSplitter(line, ',');
     Int id = 0;
-    while (splitter) {
-        std::string split = splitter();
+    for (const std::string_view split : bj::split(line, ",", bj::EmptyTokens::Keep)) {
         if (split != "x") {
-            buses.emplace_back(Bus { id, std::stoll(split) });
+            buses.emplace_back(Bus { id, bj::to_int<Int>(split) });
         }
 
         ++id;
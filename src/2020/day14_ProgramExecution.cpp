@@ -3,6 +3,7 @@
 #include <unordered_map>
 #include <regex>
 #include <bit>
+#include "../util/vm.hpp"
 
 // https://adventofcode.com/2020/day/14
 
@@ -42,67 +43,68 @@ struct Affectation {
     : address(std::stoull(address)), value(std::stoull(value)) {}
 };
 
-struct UnknownOperation { std::string line; };
-
-using Instruction = std::variant<MaskChanger, Affectation, UnknownOperation>;
-
 class ProgramExecutor {
 public:
     using Ram = std::unordered_map<Word, Word>;
-private:
-    Ram m_ram;
-    const MaskChanger * m_mask_changer = nullptr;
-    const std::vector<Instruction> * m_instructions;
-    size_t m_pc = 0;
 
-public:
-    explicit ProgramExecutor(const std::vector<Instruction> & instructions)
-    : m_instructions(&instructions){}
+    enum Opcode : std::uint8_t {
+        /** Sets the current mask to masks[arg] */
+        Mask,
+        /** Writes affectations[arg] with the current mask */
+        Write,
+        /** Line that could not be parsed */
+        Unknown
+    };
 
-    [[nodiscard]] bool is_terminated() const { return m_pc == m_instructions->size(); }
+    static constexpr std::array<std::string_view, 3> Opcode_Names { "mask", "mem", "unknown" };
 
-    template<typename Affecter>
-    bool execute(Affecter affecter) {
-        if (is_terminated()) return false;
+    /** The bytecode and the tables its arguments refer to */
+    struct Program {
+        std::vector<bj::vm::Instruction> bytecode;
+        std::vector<MaskChanger> masks;
+        std::vector<Affectation> affectations;
+    };
 
-        const Instruction & instruction = (*m_instructions)[m_pc];
+    using Affecter = void (*)(Ram & ram, Word address, Word value, const MaskChanger & mask);
 
-        struct Handler {
-            ProgramExecutor * that;
-            Affecter & affecter;
+private:
+    Ram m_ram;
+    const Program * m_program;
+    const MaskChanger * m_mask_changer = nullptr;
+    Affecter m_affecter;
 
-            void operator()(const MaskChanger & changer) {
-                that->m_mask_changer = &changer;
-            }
+public:
+    ProgramExecutor(const Program & program, Affecter affecter)
+    : m_program(&program), m_affecter(affecter) {}
 
-            void operator()(const UnknownOperation &) {}
+    template <std::size_t Opcode>
+    std::int32_t execute(const bj::vm::Instruction & instruction) {
+        if constexpr (Opcode == Mask) {
+            m_mask_changer = &m_program->masks[instruction.arg];
+        }
 
-            void operator()(const Affectation & affectation) {
-                if (that->m_mask_changer) {
-                    affecter(that->m_ram, affectation.address, affectation.value, *that->m_mask_changer);
-                }
+        if constexpr (Opcode == Write) {
+            if (m_mask_changer) {
+                const Affectation & affectation = m_program->affectations[instruction.arg];
+                m_affecter(m_ram, affectation.address, affectation.value, *m_mask_changer);
             }
-        };
-
-        std::visit(Handler{ this, affecter }, instruction);
+        }
 
-        ++m_pc;
-        return true;
+        return 1;
     }
 
     [[nodiscard]] Word sum_of_memory() const noexcept {
         Word word = 0;
-        for (const auto [_address, value] : m_ram) {
+        for (const auto & [_address, value] : m_ram) {
             word += value;
         }
         
         return word;
     }
 
-    template <typename Affecter>
-    static auto stand_alone_run(const std::vector<Instruction> & instructions, Affecter affecter) {
-        ProgramExecutor executor = ProgramExecutor(instructions);
-        while (executor.execute<Affecter>(affecter));
+    static Word stand_alone_run(const Program & program, Affecter affecter) {
+        ProgramExecutor executor = ProgramExecutor(program, affecter);
+        bj::vm::run(program.bytecode, executor);
         return executor.sum_of_memory();
     }
 };
@@ -164,22 +166,26 @@ Output day_2020_14(const std::vector<std::string> & lines, const DayExtraInfo &
     std::regex mask_regex        { R"(mask = ([X10]*))" };
     std::regex affectation_regex { R"(mem\[([0-9]*)\] = ([0-9]*))" };
 
-    const std::vector<Instruction> instructions = lines_transform::map<Instruction>(lines,
-        [&](const std::string & line) -> Instruction {
-            std::smatch smatch;
+    ProgramExecutor::Program program;
 
-            if (std::regex_search(line, smatch, mask_regex)) {
-                return MaskChanger(smatch[1].str());
-            } else if (std::regex_search(line, smatch, affectation_regex)) {
-                return Affectation(smatch[1].str(), smatch[2].str());
-            } else {
-                return UnknownOperation { line };
-            }
+    for (const std::string & line : lines) {
+        std::smatch smatch;
+
+        if (std::regex_search(line, smatch, mask_regex)) {
+            const auto index = static_cast<std::int32_t>(program.masks.size());
+            program.masks.emplace_back(smatch[1].str());
+            program.bytecode.push_back({ ProgramExecutor::Mask, 0, index });
+        } else if (std::regex_search(line, smatch, affectation_regex)) {
+            const auto index = static_cast<std::int32_t>(program.affectations.size());
+            program.affectations.emplace_back(smatch[1].str(), smatch[2].str());
+            program.bytecode.push_back({ ProgramExecutor::Write, 0, index });
+        } else {
+            program.bytecode.push_back({ ProgramExecutor::Unknown, 0, 0 });
         }
-    );
+    }
 
     return Output(
-        extra.can_skip_part_A ? 0 : ProgramExecutor::stand_alone_run(instructions, &value_masker),
-        extra.can_skip_part_B ? 0 : ProgramExecutor::stand_alone_run(instructions, &address_masker)
+        extra.can_skip_part_A ? 0 : ProgramExecutor::stand_alone_run(program, &value_masker),
+        extra.can_skip_part_B ? 0 : ProgramExecutor::stand_alone_run(program, &address_masker)
     );
 }
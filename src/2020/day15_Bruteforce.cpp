@@ -1,70 +1,69 @@
 #include "../advent_of_code.hpp"
-#include <unordered_map>
+#include "../util/big_buffer.hpp"
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 
 // https://adventofcode.com/2020/day/15
 
-struct Occurrences {
-    int lastTurn;
-    int beforeTurn;
+class RambunctiousRecitation {
+    // Turn when each number was said for the last time, not counting the
+    // current turn. 0 = never. Numbers are always lower than the number of
+    // turns, so this is a flat table instead of a hash map.
+    bj::BigBuffer<std::uint32_t> m_last_turn;
+    std::uint32_t m_turn_id = 0;
+    std::uint32_t m_last_number = 0;
 
-    [[nodiscard]] int get_turn_difference() const noexcept {
-        if (beforeTurn == 0) {
-            return 0;
-        } else {
-            return lastTurn - beforeTurn;
-        }
+    void say(std::uint32_t number) {
+        if (m_turn_id != 0) m_last_turn[m_last_number] = m_turn_id;
+        ++m_turn_id;
+        m_last_number = number;
     }
-};
 
-class RambunctiousRecitation {
-    std::unordered_map<int, Occurrences> m_occurences;
-    int m_turn_id = 0;
-    int m_last_number = 0;
 public:
-    void add(int number) {
-        ++m_turn_id;
-
-        const auto it = m_occurences.find(number);
-        if (it == m_occurences.end()) {
-            m_occurences[number] = Occurrences{ m_turn_id , 0 };
-        } else {
-            it->second.beforeTurn = it->second.lastTurn;
-            it->second.lastTurn = m_turn_id;
-        }
+    explicit RambunctiousRecitation(std::size_t table_size) : m_last_turn(table_size, 0) {}
 
-        m_last_number = number;
-    }
+    void add(std::uint32_t number) { say(number); }
 
     void next() {
-        const auto it = m_occurences.find(m_last_number);
-        add(it->second.get_turn_difference());
+        const std::uint32_t last_turn = m_last_turn[m_last_number];
+        say(last_turn == 0 ? 0 : m_turn_id - last_turn);
     }
 
-    [[nodiscard]] bool is_turn(int turn_id) const noexcept {
+    [[nodiscard]] bool is_turn(std::uint32_t turn_id) const noexcept {
         return m_turn_id == turn_id;
     }
 
-    [[nodiscard]] int last_number() const noexcept { return m_last_number; }
+    [[nodiscard]] std::uint32_t last_number() const noexcept { return m_last_number; }
 };
 
 Output day_2020_15(const std::vector<std::string> & lines, const DayExtraInfo & extra) {
+    constexpr std::uint32_t Part_A_Turn = 2020;
+    constexpr std::uint32_t Part_B_Turn = 30000000;
+
+    std::vector<std::uint32_t> starting_numbers;
     StringSplitter splitter = StringSplitter(lines[0], ',');
+    while (splitter) {
+        starting_numbers.push_back(static_cast<std::uint32_t>(std::stoul(splitter())));
+    }
 
-    RambunctiousRecitation instance;
+    const std::uint32_t last_turn = extra.can_skip_part_B ? Part_A_Turn : Part_B_Turn;
+    const std::uint32_t highest_start = *std::max_element(starting_numbers.begin(), starting_numbers.end());
 
-    while (splitter) {
-        instance.add(std::stoi(splitter()));
+    RambunctiousRecitation instance(std::max(last_turn, highest_start + 1));
+
+    for (const std::uint32_t number : starting_numbers) {
+        instance.add(number);
     }
 
-    while (!instance.is_turn(2020)) {
+    while (!instance.is_turn(Part_A_Turn)) {
         instance.next();
     }
 
-    const int number_at_2020 = instance.last_number();
+    const std::uint32_t number_at_2020 = instance.last_number();
     
     if (!extra.can_skip_part_B) {
-        while (!instance.is_turn(30000000)) {
+        while (!instance.is_turn(Part_B_Turn)) {
             instance.next();
         }
     }
@@ -1,4 +1,5 @@
 #include "../advent_of_code.hpp"
+#include "../util/string_split.hpp"
 #include "../libs_ensemblist.hpp"
 
 #include <unordered_map>
@@ -34,8 +35,11 @@ struct Ticket {
     std::vector<int> values;
 
     Ticket() = default;
-    Ticket(const std::string & line)
-    : values(StringSplitter::line_to_vector<int>(line, to_int, ',')) {}
+    Ticket(const std::string & line) {
+        for (const std::string_view value : bj::split(line, ",")) {
+            values.push_back(bj::to_int(value));
+        }
+    }
 
     friend std::ostream & operator<<(std::ostream & stream, const Ticket & ticket) {
         bool first = true;
@@ -47,8 +51,6 @@ struct Ticket {
         return stream;
     }
 
-    static int to_int(const std::string & str) { return std::stoi(str); }
-
     [[nodiscard]] std::optional<size_t> find_unmatching_field(const std::vector<Restriction2> & restrictions) const {
         const auto invalid_field = std::find_if(values.begin(), values.end(), [&](int value) {
             return std::all_of(restrictions.begin(), restrictions.end(), [&](const auto & restrictionx2) {
@@ -122,10 +124,10 @@ public:
     }
 
     void deduce_fields() {
-        std::map<size_t, std::set<size_t>> possibilitiess = [](size_t size) {
-            std::map<size_t, std::set<size_t>> retval;
+        std::map<size_t, set::DenseSet<size_t>> possibilitiess = [](size_t size) {
+            std::map<size_t, set::DenseSet<size_t>> retval;
 
-            std::set<size_t> all_values;
+            set::DenseSet<size_t> all_values;
             for (size_t j = 0 ; j != size ; ++j) {
                 all_values.insert(j);
             }
@@ -139,13 +141,16 @@ public:
         
         for (const Ticket & ticket : m_other_tickets) {
             for (auto & [ticket_id, allowed_fields] : possibilitiess) {
-                std::erase_if(allowed_fields, [&](size_t field_id) {
+                erase_if(allowed_fields, [&](size_t field_id) {
                     return !Restriction::match_restriction_2(m_restrictions[field_id], ticket[ticket_id]);
                 });
             }
         }
         
-        set::resolve_key_to_value(possibilitiess);
+        if (!set::resolve_key_to_value(possibilitiess)) {
+            std::cerr << "2020-16: the fields can not be matched to the ticket positions\n";
+            return;
+        }
 
         m_position_in_ticket_to_field = std::vector<size_t>();
         for (const auto & [_column_id, values] : possibilitiess) {
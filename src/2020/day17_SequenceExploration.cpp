@@ -1,12 +1,13 @@
 #include "../advent_of_code.hpp"
+#include "../util/flat_hash.hpp"
+#include "../util/stencil.hpp"
 
 #include <algorithm>
-#include <unordered_map>
 #include <map>
-#include <unordered_set>
 #include <set>
 #include <vector>
 #include <functional>
+#include <memory_resource>
 
 
 // https://adventofcode.com/2020/day/17
@@ -62,57 +63,22 @@ struct Position {
 
     template <typename Consumer>
     void for_each_neighbour_position(Consumer consumer) const {
-        // Instead of searching recursively in a tree structure, we could reuse
-        // vector_implementation::SpaceSize to have a mapping between 0 -> 3^NB_DIM -1 values
-        // and offset positions
-
-        Position offset;
-        offset.m_coordinate.fill(-1);
-
-        size_t i = 0;
-        while (true) {
-            if (i != NB_DIM) {
-                // On a non 1 coordinate, go to next coordinate
-                ++i;
-            } else {
-                // We have a new neighbour coordinate, apply consumer
-                if (std::any_of(offset.m_coordinate.begin(), offset.m_coordinate.end(), [](int x) { return x != 0; })) {
-                    consumer(*this + offset);
-                }
-
-                // Go back to last non 1 coordinate
-                while (true) {
-                    if (i == 0) {
-                        // offset was 1 (...) 1
-                        return;
-                    }
-
-                    --i;
-                    
-                    if (offset.m_coordinate[i] == 1) {
-                        offset.m_coordinate[i] = -1; // Reset
-                        // go back
-                    } else /* if (offset.m_coordinate[i] != 1) */ {
-                        ++offset.m_coordinate[i];
-                        break;
-                    }
-                }
+        for (const auto & offset : bj::stencil::moore<NB_DIM>) {
+            Position neighbour = *this;
+            for (size_t i = 0 ; i != NB_DIM ; ++i) {
+                neighbour.m_coordinate[i] += offset[i];
             }
+
+            consumer(neighbour);
         }
     }
 };
 
-namespace std {
-    template <size_t NB_DIM> struct hash<Position<NB_DIM>> {
-        std::size_t operator()(const Position<NB_DIM> & pos) const noexcept {
-            size_t h = 0;
-            for (size_t i = 0 ; i != NB_DIM ; ++i) {
-                h = h * 31 + std::hash<int>()(pos.m_coordinate[i]);
-            }
-            return h;
-        }
-    };
-}
+template <size_t NB_DIM> struct bj::Hash<::Position<NB_DIM>> {
+    [[nodiscard]] std::size_t operator()(const ::Position<NB_DIM> & pos) const noexcept {
+        return bj::Hash<std::array<int, NB_DIM>>()(pos.m_coordinate);
+    }
+};
 
 namespace vector_implementation {
     // Hard coding 3D / 4D is too mainstream.
@@ -266,13 +232,17 @@ namespace map_implementation {
         // using Set = std::set<Position<NB_DIM>>;
         // using Map = std::map<Position<NB_DIM>, size_t>;
 
-        using Set = std::unordered_set<Position<NB_DIM>>;
-        using Map = std::unordered_map<Position<NB_DIM>, size_t>;
+        using Set = bj::FlatHashSet<Position<NB_DIM>, bj::Hash<Position<NB_DIM>>,
+            std::pmr::polymorphic_allocator<Position<NB_DIM>>>;
+        using Map = bj::FlatHashMap<Position<NB_DIM>, size_t, bj::Hash<Position<NB_DIM>>,
+            std::pmr::polymorphic_allocator<std::pair<Position<NB_DIM>, size_t>>>;
 
+        std::pmr::memory_resource * m_memory_resource;
         Set occupied_slots;
 
     public:
-        explicit Field(const std::vector<std::string> & lines) {
+        Field(const std::vector<std::string> & lines, std::pmr::memory_resource * memory_resource)
+        : m_memory_resource(memory_resource), occupied_slots(memory_resource) {
             for (size_t y = 0 ; y != lines.size() ; ++y) {
                 for (size_t x = 0 ; x != lines[y].size() ; ++x) {
                     if (lines[y][x] == '#') {
@@ -287,7 +257,8 @@ namespace map_implementation {
         }
 
         void next() {
-            Map activated_neighbours;
+            Map activated_neighbours { m_memory_resource };
+            activated_neighbours.reserve(occupied_slots.size() * 8);
 
             for (const auto & occupied_position : occupied_slots) {
                 occupied_position.for_each_neighbour_position(
@@ -297,7 +268,7 @@ namespace map_implementation {
                 );
             }
 
-            Set new_occupation;
+            Set new_occupation { m_memory_resource };
 
             for (const auto & [position, occupied_neighbours] : activated_neighbours) {
                 if (occupied_slots.contains(position)) {
@@ -317,8 +288,8 @@ namespace map_implementation {
 }
 
 template<typename FieldClass>
-static auto occupied_after_six_iterations(const std::vector<std::string> & lines) {
-    FieldClass field { lines };
+static auto occupied_after_six_iterations(const std::vector<std::string> & lines, std::pmr::memory_resource * memory_resource) {
+    FieldClass field { lines, memory_resource };
 
     for (size_t i = 0 ; i != 6 ; ++i) field.next();
 
@@ -326,9 +297,9 @@ static auto occupied_after_six_iterations(const std::vector<std::string> & lines
 }
 
 /// 3D / 4D game of life
-Output day_2020_17(const std::vector<std::string> & lines, const DayExtraInfo &) {
+Output day_2020_17(const std::vector<std::string> & lines, const DayExtraInfo & dei) {
     return Output(
-        occupied_after_six_iterations<map_implementation::Field<3>>(lines),
-        occupied_after_six_iterations<map_implementation::Field<4>>(lines)
+        occupied_after_six_iterations<map_implementation::Field<3>>(lines, dei.memory_resource),
+        occupied_after_six_iterations<map_implementation::Field<4>>(lines, dei.memory_resource)
     );
 }
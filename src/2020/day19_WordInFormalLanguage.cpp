@@ -1,4 +1,5 @@
 #include "../advent_of_code.hpp"
+#include "../util/string_split.hpp"
 
 #include <algorithm>
 #include <vector>
@@ -19,20 +20,11 @@ struct ComplexRule {
     std::vector<std::vector<RuleNumber>> next_rules;
 
     explicit ComplexRule(std::string_view str) {
-        StringSplitter pipeSplitter { str, '|' };
-
-        while (pipeSplitter) {
-            std::string rule = pipeSplitter();
+        for (const std::string_view rule : bj::split(str, "|", bj::EmptyTokens::Keep)) {
             next_rules.push_back({});
 
-            StringSplitter valSplitter { rule, ' ' };
-
-            while (valSplitter) {
-                std::string rule_number_str = valSplitter();
-
-                if (!rule_number_str.empty()) {
-                    next_rules.back().emplace_back(std::stoi(rule_number_str));
-                }
+            for (const std::string_view rule_number_str : bj::split(rule, " ")) {
+                next_rules.back().emplace_back(bj::to_int<RuleNumber>(rule_number_str));
             }
         }
     }
@@ -1,5 +1,7 @@
 #include "../advent_of_code.hpp"
 #include "../libs_ensemblist.hpp"
+#include "../util/string_split.hpp"
+#include "../util/symbol_table.hpp"
 
 #include <map>
 #include <set>
@@ -8,44 +10,42 @@
 
 namespace {
 
-using Ingredient = std::string;
+using Ingredient = bj::SymbolId;
 using Alergen = std::string;
 
-using ReaderRetVal = std::pair<std::set<Ingredient>, std::set<Alergen>>;
+using Ingredients = set::DenseSet<Ingredient>;
 
-ReaderRetVal reader(const std::string & line) {
-    std::string ingredients_str = line.substr(0, line.find("(contains") - 1);
-    std::set<Ingredient> ingredients;
-    StringSplitter ingredients_splitter { ingredients_str, ' ' };
-    while (ingredients_splitter) {
-        std::string s = ingredients_splitter();
-        ingredients.insert(std::move(s));
+using ReaderRetVal = std::pair<Ingredients, std::set<Alergen>>;
+
+ReaderRetVal reader(std::string_view line, bj::SymbolTable & ingredient_names) {
+    const size_t contains_pos = line.find("(contains");
+
+    Ingredients ingredients;
+    for (const std::string_view ingredient : bj::split(line.substr(0, contains_pos), " ")) {
+        ingredients.insert(ingredient_names.intern(ingredient));
     }
 
-    std::string contains = line.substr(line.find("(contains"));
-    contains = contains.substr(10);
-    contains = contains.substr(0, contains.length() - 1);
+    std::string_view contains = line.substr(contains_pos + std::strlen("(contains "));
+    contains.remove_suffix(1);
     std::set<Alergen> alergens;
-    StringSplitter alergen_splitter { contains, ',' };
-    while (alergen_splitter) {
-        std::string s = alergen_splitter();
-        if (s[0] == ' ') s = s.substr(1);
-        alergens.insert(std::move(s));
+    for (const std::string_view alergen : bj::split(contains, ", ")) {
+        alergens.emplace(alergen);
     }
 
     return ReaderRetVal(std::move(ingredients), std::move(alergens));
 }
 
 struct InitialValues {
-    std::map<Ingredient, size_t> ingredients_occurrences;
-    std::map<Alergen, std::set<Ingredient>> alergens;
+    bj::SymbolTable ingredient_names;
+    bj::SymbolVector<size_t> ingredients_occurrences;
+    std::map<Alergen, Ingredients> alergens;
 };
 
 InitialValues read(const std::vector<std::string> & lines) {
     InitialValues retval;
 
     for (const auto & line : lines) {
-        const auto [ingredients, alergens] = reader(line);
+        const auto [ingredients, alergens] = reader(line, retval.ingredient_names);
 
         for (const auto & alergen : alergens) {
             const auto it = retval.alergens.find(alergen);
@@ -65,11 +65,11 @@ InitialValues read(const std::vector<std::string> & lines) {
     return retval;
 }
 
-std::set<Ingredient> get_safe_ingredients(
-    const std::map<Alergen, std::set<Ingredient>> & mapping,
-    const std::set<Ingredient> & all_ingredients) {
+Ingredients get_safe_ingredients(
+    const std::map<Alergen, Ingredients> & mapping,
+    const Ingredients & all_ingredients) {
 
-    std::set<Ingredient> contaminated;
+    Ingredients contaminated;
     for (const auto & [alergen, ingredients] : mapping) {
         contaminated |= ingredients;
     }
@@ -80,20 +80,30 @@ std::set<Ingredient> get_safe_ingredients(
 }
 
 Output day_2020_21(const std::vector<std::string> & lines, const DayExtraInfo &) {
-    auto [ingredients_occurrences, mapping] = read(lines);
-    set::resolve_key_to_value(mapping);
+    auto [ingredient_names, ingredients_occurrences, mapping] = read(lines);
+    const bool resolved = set::resolve_key_to_value(mapping);
+
+    Ingredients all_ingredients;
+    for (Ingredient ingredient = 0 ; ingredient != ingredient_names.size() ; ++ingredient) {
+        all_ingredients.insert(ingredient);
+    }
 
-    std::set<Ingredient> safe_ingredients = get_safe_ingredients(mapping, set::to_set(ingredients_occurrences));
+    const Ingredients safe_ingredients = get_safe_ingredients(mapping, all_ingredients);
 
     long long int r1 = 0;
-    for (const auto & safe : safe_ingredients) {
-        r1 += ingredients_occurrences.find(safe)->second;
+    for (const Ingredient safe : safe_ingredients) {
+        r1 += ingredients_occurrences[safe];
+    }
+
+    if (!resolved) {
+        std::cerr << "2020-21: the allergens can not be matched to ingredients\n";
+        return Output(r1, std::string());
     }
 
     std::string r2 = "";
     for (const auto & [alergen, ingredient] : mapping) {
         if (!r2.empty()) r2 += ',';
-        r2 += *ingredient.begin();
+        r2 += ingredient_names.name(*ingredient.begin());
     }
     
     return Output(r1, r2);
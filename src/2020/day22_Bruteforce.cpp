@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <set>
+#include <memory_resource>
 
 // https://adventofcode.com/2020/day/22
 
@@ -9,18 +10,24 @@ class Game {
 private:
     using Card = size_t;
     using Deck = std::vector<Card>;     // std::vector is faster than std::deque
-    using PreviousRoundKey = std::pair<Deck, Deck>;
+    using PreviousRoundKey = std::pair<std::pmr::vector<Card>, std::pmr::vector<Card>>;
     Deck m_player_1;
     Deck m_player_2;
 
-    std::set<PreviousRoundKey> m_previous_rounds;
+    std::pmr::set<PreviousRoundKey> m_previous_rounds;
 
-    [[nodiscard]] bool already_saw_this(const PreviousRoundKey & key) const {
-        return m_previous_rounds.contains(key);
+    /// Stores the current decks. Returns false if they were already seen.
+    [[nodiscard]] bool mark_as_seen() {
+        return m_previous_rounds.emplace(
+            std::piecewise_construct,
+            std::forward_as_tuple(m_player_1.begin(), m_player_1.end()),
+            std::forward_as_tuple(m_player_2.begin(), m_player_2.end())
+        ).second;
     }
 
 public:
-    explicit Game(const std::vector<std::string> & lines) {
+    Game(const std::vector<std::string> & lines, std::pmr::memory_resource * memory_resource)
+    : m_previous_rounds(memory_resource) {
         bool on_player_1 = true;
         for (const auto & line : lines) {
             if (line == "") continue;
@@ -38,7 +45,8 @@ public:
         }
     }
 
-    Game(const Game & original, size_t cards_p1, size_t cards_p2) {
+    Game(const Game & original, size_t cards_p1, size_t cards_p2)
+    : m_previous_rounds(original.m_previous_rounds.get_allocator()) {
         for (size_t i = 0 ; i != cards_p1 ; ++i) {
             m_player_1.push_back(original.m_player_1[i]);
         }
@@ -64,15 +72,11 @@ public:
 
     template <typename WinnerRule>
     void play(WinnerRule winner_rule) {
-        const PreviousRoundKey key = std::pair(m_player_1, m_player_2);
-
-        if (already_saw_this(key)) {
+        if (!mark_as_seen()) {
             m_player_2.clear();
             return;
         }
 
-        m_previous_rounds.insert(key);
-
         const Card card_1 = m_player_1.front();    m_player_1.erase(m_player_1.begin());
         const Card card_2 = m_player_2.front();    m_player_2.erase(m_player_2.begin());
 
@@ -105,9 +109,9 @@ public:
     }
 };
 
-Output day_2020_22(const std::vector<std::string> & lines, const DayExtraInfo &) {
-    Game game { lines };
-    Game recursive_game = game;
+Output day_2020_22(const std::vector<std::string> & lines, const DayExtraInfo & dei) {
+    Game game { lines, dei.memory_resource };
+    Game recursive_game { lines, dei.memory_resource };
 
     while (!game.ended()) {
         game.play(Game::regular);
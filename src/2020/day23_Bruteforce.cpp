@@ -1,4 +1,5 @@
 #include "../advent_of_code.hpp"
+#include "../util/big_buffer.hpp"
 
 #include <vector>
 #include <algorithm>
@@ -7,6 +8,9 @@
 
 using Cup = size_t;
 
+// Cup -> the next cup. Part B walks a million of them in a random order.
+using LinkedCups = bj::BigBuffer<std::uint32_t>;
+
 static std::vector<Cup> read(const std::string & line) {
     std::vector<Cup> x;
 
@@ -65,7 +69,7 @@ static auto do_part_a(std::vector<Cup> cups, int rounds) {
     return answer;
 }
 
-[[maybe_unused]] static void print_linked_elements(std::ostream & stream, const std::vector<size_t> & linked_list) {
+[[maybe_unused]] static void print_linked_elements(std::ostream & stream, const LinkedCups & linked_list) {
     stream << "- As a map:\n";
     size_t i = 0;
     for (auto x : linked_list) {
@@ -86,11 +90,11 @@ static auto do_part_a(std::vector<Cup> cups, int rounds) {
     stream << "...\n";
 }
 
-static std::vector<size_t> to_linked_map(const std::vector<Cup> & cups, const Cup max_cup) {
-    std::vector<size_t> linked_list;
+static LinkedCups to_linked_map(const std::vector<Cup> & cups, const Cup max_cup) {
+    LinkedCups linked_list(max_cup + 1);
     
     // Cup 0 is a pointer to the "first" element (for display)
-    linked_list.push_back(cups.empty() ? 1 : cups[0]);
+    linked_list[0] = cups.empty() ? 1 : cups[0];
 
     // linked_list can now be a map : Cup -> the next Cup/Cup index
     for (Cup cup = 1 ; cup <= max_cup ; ++cup) {
@@ -98,9 +102,9 @@ static std::vector<size_t> to_linked_map(const std::vector<Cup> & cups, const Cu
 
         if (cup_it == cups.end()) {
             if (cup != max_cup) {
-                linked_list.push_back(cup + 1);
+                linked_list[cup] = cup + 1;
             } else {
-                linked_list.push_back(cups.empty() ? 1 : cups[0]);
+                linked_list[cup] = cups.empty() ? 1 : cups[0];
             }
 
             continue;
@@ -108,14 +112,14 @@ static std::vector<size_t> to_linked_map(const std::vector<Cup> & cups, const Cu
 
         const auto next_cup_it = cup_it + 1;
         if (next_cup_it != cups.end()) {
-            linked_list.push_back(*next_cup_it);
+            linked_list[cup] = *next_cup_it;
             continue;
         }
 
         if (cup != max_cup) {
-            linked_list.push_back(cups.size() + 1);
+            linked_list[cup] = cups.size() + 1;
         } else {
-            linked_list.push_back(cups.empty() ? 1 : cups[0]);
+            linked_list[cup] = cups.empty() ? 1 : cups[0];
         }
     }
 
@@ -123,7 +127,7 @@ static std::vector<size_t> to_linked_map(const std::vector<Cup> & cups, const Cu
 }
 
 static auto do_part_b(const std::vector<Cup> & cups, const Cup max_cup, size_t number_of_rounds) {
-    std::vector<size_t> linked_list = to_linked_map(cups, max_cup);
+    LinkedCups linked_list = to_linked_map(cups, max_cup);
 
     size_t i = 0;
     while (--number_of_rounds != 0) {
@@ -146,7 +150,7 @@ static auto do_part_b(const std::vector<Cup> & cups, const Cup max_cup, size_t n
 
     // if (max_cup < 100) print_linked_elements(std::cout, linked_list);
     
-    return linked_list[1] * linked_list[linked_list[1]];
+    return static_cast<std::uint64_t>(linked_list[1]) * linked_list[linked_list[1]];
 }
 
 Output day_2020_23(const std::vector<std::string> & lines, const DayExtraInfo &) {
@@ -1,17 +1,12 @@
 #include "../advent_of_code.hpp"
-
-#include <set>
-#include <map>
+#include "../util/flat_hash.hpp"
+#include "../util/game_of_life.hpp"
+#include "../util/stencil.hpp"
 
 // https://adventofcode.com/2020/day/24
 
 enum class HexaDirection { e, se, sw, w, nw, ne };
 
-static constexpr auto DIRECTIONS = {
-    HexaDirection::e , HexaDirection::ne, HexaDirection::nw,
-    HexaDirection::se, HexaDirection::sw, HexaDirection::w
-};
-
 static auto to_directions(std::string_view line) {
     std::vector<HexaDirection> retval;
 
@@ -54,13 +49,13 @@ struct Position {
         }
     }
 
-    [[nodiscard]] bool operator<(const Position & rhs) const {
-        if (x < rhs.x) return true;
-        if (x > rhs.x) return false;
-        if (y < rhs.y) return true;
-        if (y > rhs.y) return false;
-        return false;
-    }
+    [[nodiscard]] bool operator==(const Position & rhs) const = default;
+
+    struct Hash {
+        [[nodiscard]] size_t operator()(const Position & p) const noexcept {
+            return bj::hash_integers(p.x, p.y);
+        }
+    };
     
     void move(HexaDirection direction) {
         switch (direction) {
@@ -72,19 +67,12 @@ struct Position {
             case HexaDirection::ne:     x += 1; y -= 1; break;
         }
     }
-
-    template <typename Consumer>
-    void for_each_adjacent(Consumer c) const {
-        for (auto d : DIRECTIONS) {
-            Position p  = *this;
-            p.move(d);
-            c(p);
-        }
-    }
 };
 
+using Tiles = bj::FlatHashSet<Position, Position::Hash>;
+
 static auto to_tiles(const std::vector<std::vector<HexaDirection>> & directionss) {
-    std::set<Position> black_tiles;
+    Tiles black_tiles;
 
     for (const auto & directions : directionss) {
         Position current { directions };
@@ -99,37 +87,48 @@ static auto to_tiles(const std::vector<std::vector<HexaDirection>> & directionss
     return black_tiles;
 }
 
-static std::set<Position> game_of_life(std::set<Position> black) {
-    std::map<Position, int> black_neighbours;
+/**
+ * Flipping rules of the tiles. The positions are axial coordinates (see
+ * Position::move), so the rules can be run by bj::game_of_life.
+ */
+struct HexagonalRules {
+    using Element = bj::Position;
+    static constexpr bool Is_Outer_Totalistic = true;
 
-    for (const auto & position : black) {
-        position.for_each_adjacent([&](Position p) {
-            ++black_neighbours[p];
-        });
+    [[nodiscard]] static std::array<bj::Position, 6> get_neighbours(const bj::Position & tile) {
+        std::array<bj::Position, 6> neighbours;
+
+        for (size_t i = 0 ; i != neighbours.size() ; ++i) {
+            const auto & offset = bj::stencil::hexagonal[i];
+            neighbours[i] = bj::Position { tile.x + offset[0], tile.y + offset[1] };
+        }
+
+        return neighbours;
     }
 
-    std::set<Position> result;
+    [[nodiscard]] static bool is_valid(const bj::Position &) noexcept { return true; }
 
-    for (const auto & [tile, black_neighbour] : black_neighbours) {
-        if (!black.contains(tile)) {
-            if (black_neighbour == 2) result.insert(tile);
+    [[nodiscard]] static bool is_on(const bj::Position &, const bool was_black, const size_t black_neighbours) noexcept {
+        if (was_black) {
+            return !(black_neighbours == 0 || black_neighbours > 2);
         } else {
-            if (!(black_neighbour == 0 || black_neighbour > 2)) result.insert(tile);
+            return black_neighbours == 2;
         }
     }
+};
 
-    return result;
-}
-
-Output day_2020_24(const std::vector<std::string> & lines, const DayExtraInfo &) {
+Output day_2020_24(const std::vector<std::string> & lines, const DayExtraInfo & dei) {
     const auto directionss = lines_transform::map<std::vector<HexaDirection>>(lines, to_directions);
 
-    auto black_tiles = to_tiles(directionss);
-    const size_t init_black_tiles = black_tiles.size();
+    const auto black_tiles = to_tiles(directionss);
 
-    for (size_t i = 0 ; i != 100 ; ++i) {
-        black_tiles = game_of_life(black_tiles);
+    std::set<bj::Position> black_positions;
+    for (const Position & tile : black_tiles) {
+        black_positions.insert(bj::Position { tile.x, tile.y });
     }
-    
-    return Output(init_black_tiles, black_tiles.size());
+
+    const size_t days = dei.part_b_extra_param;
+    const auto black_tiles_after = bj::game_of_life(days, black_positions, HexagonalRules {});
+
+    return Output(black_tiles.size(), black_tiles_after.size());
 }
@@ -1,13 +1,17 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <variant>
 #include <vector>
 #include <string>
 #include <string_view>
 #include <optional>
+#include <span>
 #include <iostream>
 #include <chrono>
+#include <cstring>
+#include <memory_resource>
 
 #include <fstream>
 #include <sstream>
@@ -23,6 +27,8 @@ namespace test {
 
         Type        type;
         std::string value;
+        /** Numbers before the value, each followed by ` */
+        std::vector<int> extra_parameters;
         int extra_parameter = 0;
 
         explicit Expected(std::string line);
@@ -185,8 +191,19 @@ struct DayExtraInfo {
     int  part_a_extra_param = 0;
     bool can_skip_part_B = false;
     int  part_b_extra_param = 0;
+    /// Every extra parameter of the part (part_x_extra_param is the first one)
+    std::span<const int> part_a_extra_params;
+    std::span<const int> part_b_extra_params;
+    /// Arena for the allocations of the day, freed at once after the run
+    std::pmr::memory_resource * memory_resource = std::pmr::get_default_resource();
 };
 
+/**
+ * Pull-style splitter on a single character.
+ *
+ * Kept for the call sites that still want std::strings: new code should
+ * iterate on bj::split (util/string_split.hpp), which does not allocate.
+ */
 class StringSplitter {
     std::string_view::const_iterator pos;
     std::string_view::const_iterator end;
@@ -196,7 +213,8 @@ public:
     explicit StringSplitter(const std::string_view & str, char split_character = ' ')
     : pos(str.begin()), end(str.end()), split_character(split_character) {}
 
-    std::string operator()() {
+    /** Returns the next token as a view on the split string */
+    std::string_view next_view() {
         const auto from = pos;
 
         while (pos != end && *pos != split_character) {
@@ -209,7 +227,11 @@ public:
             ++pos;
         }
 
-        return std::string(from, to);
+        return std::string_view(from, to);
+    }
+
+    std::string operator()() {
+        return std::string(next_view());
     }
 
     [[nodiscard]] operator bool() const { return pos != end; }
@@ -227,52 +249,106 @@ public:
     }
 };
 
+/**
+ * A 2D grid of chars, stored in one buffer with a border of
+ * Out_Of_Bounds cells around it.
+ *
+ * Thanks to the border, the direct neighbours of every cell can be read with
+ * `at` without any bound check: x - 1 and y - 1 may underflow.
+ *
+ * The width is the one of the first line. Shorter lines are padded with
+ * Out_Of_Bounds, longer ones are cut.
+ */
 struct Board {
-    std::vector<std::vector<char>> m_board;
+    static constexpr char Out_Of_Bounds = '\0';
+
+private:
+    size_t m_width  = 0;
+    size_t m_height = 0;
+    size_t m_stride = 2;
+    std::vector<char> m_board;
+
+    [[nodiscard]] size_t index_of(size_t x, size_t y) const noexcept {
+        return (y + 1) * m_stride + (x + 1);
+    }
 
 public:
-    explicit Board(const std::vector<std::string> & lines) {
-        for (const auto & line : lines) {
-            m_board.emplace_back(line.begin(), line.end());
+    explicit Board(const std::vector<std::string> & lines)
+    : m_width(lines.empty() ? 0 : lines[0].size()), m_height(lines.size()), m_stride(m_width + 2),
+      m_board(m_stride * (m_height + 2), Out_Of_Bounds) {
+        for (size_t y = 0 ; y != m_height ; ++y) {
+            const size_t length = std::min(lines[y].size(), m_width);
+            std::copy(lines[y].begin(), lines[y].begin() + length, m_board.begin() + index_of(0, y));
         }
     }
 
-    [[nodiscard]] size_t height() const { return m_board.size(); }
-
-    // Board should not be empty
-    [[nodiscard]] size_t width() const { return m_board[0].size(); }
+    [[nodiscard]] size_t height() const noexcept { return m_height; }
+    [[nodiscard]] size_t width()  const noexcept { return m_width;  }
 
     [[nodiscard]] std::optional<char> get_at(size_t x, size_t y) const {
         if (x >= width()) return std::nullopt;
         if (y >= height()) return std::nullopt;
-        return m_board[y][x];
+        return m_board[index_of(x, y)];
     }
 
+    /** Unchecked access. x and y can be one cell out of the board. */
+    [[nodiscard]] char at(size_t x, size_t y) const noexcept {
+        return m_board[index_of(x, y)];
+    }
+
+    /** The cells of row y. [-1] and [width()] are Out_Of_Bounds. */
+    [[nodiscard]] const char * row(size_t y) const noexcept { return m_board.data() + index_of(0, y); }
+    [[nodiscard]] char *       row(size_t y)       noexcept { return m_board.data() + index_of(0, y); }
+
     void set_at(size_t x, size_t y, char c) {
-        m_board[y][x] = c;
+        m_board[index_of(x, y)] = c;
     }
 
     [[nodiscard]] int normalize_x(int x) const { return x % width();  }
     [[nodiscard]] int normalize_y(int y) const { return y % height(); }
 
     [[nodiscard]] bool operator==(const Board & other) const {
-        return m_board == other.m_board;
+        return m_width == other.m_width && m_board == other.m_board;
+    }
+
+    /** Exchanges the content of two boards, for double buffering */
+    void swap(Board & other) noexcept {
+        std::swap(m_width, other.m_width);
+        std::swap(m_height, other.m_height);
+        std::swap(m_stride, other.m_stride);
+        m_board.swap(other.m_board);
     }
 };
 
+/**
+ * A cursor on a board, that can loop on the x and y axis.
+ *
+ * The moves are described by Steps, in which the offsets on the looping
+ * axis are already reduced to [0, length[: moving is then an addition and
+ * a conditional subtraction instead of a modulo.
+ */
 class BoardPosition {
+public:
+    struct Step {
+        size_t x;
+        size_t y;
+    };
+
+private:
     size_t m_x;       bool loop_x;
     size_t m_y;       bool loop_y;
     Board * board;
 
-    static void offset_helper(size_t & i, int offset, size_t length, bool is_looped) {
-        if (!is_looped) {
-            i += offset;
-            return;
-        }
+    [[nodiscard]] static size_t step_helper(int offset, size_t length, bool is_looped) {
+        if (!is_looped) return static_cast<size_t>(offset);
+
+        const int length_as_int = static_cast<int>(length);
+        return static_cast<size_t>(((offset % length_as_int) + length_as_int) % length_as_int);
+    }
 
-        int i_as_int = (static_cast<int>(i) + offset) % length;
-        i = static_cast<size_t>(i_as_int);
+    static void advance_helper(size_t & i, size_t step, size_t length, bool is_looped) {
+        i += step;
+        if (is_looped && i >= length) i -= length;
     }
 
 public:
@@ -287,9 +363,20 @@ public:
         board->set_at(m_x, m_y, c);
     }
 
+    [[nodiscard]] Step make_step(int x, int y) const {
+        return Step {
+            step_helper(x, board->width() , loop_x),
+            step_helper(y, board->height(), loop_y)
+        };
+    }
+
+    void advance(Step step) {
+        advance_helper(m_x, step.x, board->width() , loop_x);
+        advance_helper(m_y, step.y, board->height(), loop_y);
+    }
+
     void offset(int x, int y) {
-        offset_helper(m_x, x, board->width() , loop_x);
-        offset_helper(m_y, y, board->height(), loop_y);
+        advance(make_step(x, y));
     }
 };
 
@@ -333,26 +420,25 @@ namespace lines_transform {
     std::vector<D> group(const std::vector<std::string> & lines, Mapper mapper, Reducer reducer, Finalize finalizer) {
         std::vector<D> values;
 
-        std::optional<I> accumulator = std::nullopt;
-
-        const auto append = [&]() {
-            if (accumulator) {
-                values.emplace_back(finalizer(accumulator.value()));
-                accumulator = std::nullopt;
+        // A group is a run of non empty lines
+        size_t begin = 0;
+        while (begin != lines.size()) {
+            if (lines[begin].empty()) {
+                ++begin;
+                continue;
             }
-        };
 
-        for (const std::string & line : lines) {
-            if (line == "") {
-                append();
-            } else if (!accumulator.has_value()) {
-                accumulator = mapper(line);
-            } else {
-                accumulator = reducer(accumulator.value(), mapper(line));
+            I accumulator = mapper(lines[begin]);
+
+            size_t end = begin + 1;
+            while (end != lines.size() && !lines[end].empty()) {
+                accumulator = reducer(accumulator, mapper(lines[end]));
+                ++end;
             }
-        }
 
-        append();
+            values.emplace_back(finalizer(accumulator));
+            begin = end;
+        }
 
         return values;
     }
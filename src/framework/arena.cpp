@@ -0,0 +1,34 @@
+#include "arena.h"
+#include <algorithm>
+
+void * DayArena::CountingResource::do_allocate(size_t bytes, size_t alignment) {
+    allocated += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void DayArena::CountingResource::do_deallocate(void * p, size_t bytes, size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
+
+bool DayArena::CountingResource::do_is_equal(const std::pmr::memory_resource & other) const noexcept {
+    return this == &other;
+}
+
+DayArena::DayArena() : m_buffer(new std::byte[Initial_Size]), m_buffer_size(Initial_Size) {
+    m_resource.emplace(m_buffer.get(), m_buffer_size, &m_upstream);
+}
+
+void DayArena::reset() {
+    const size_t needed = std::min(m_buffer_size + m_upstream.allocated, Max_Kept_Size);
+
+    // Free the chunks that were allocated out of the buffer
+    m_resource.reset();
+    m_upstream.allocated = 0;
+
+    if (needed > m_buffer_size) {
+        m_buffer.reset(new std::byte[needed]);
+        m_buffer_size = needed;
+    }
+
+    m_resource.emplace(m_buffer.get(), m_buffer_size, &m_upstream);
+}
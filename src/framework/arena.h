@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+/**
+ * Memory resource given to the days through DayExtraInfo.
+ *
+ * Allocations are pointer bumps in a buffer that is kept from one run to
+ * the other: deallocations do nothing, and the whole arena is reset after
+ * each run. If a run needed more memory than the buffer, the buffer grows
+ * for the next runs (up to Max_Kept_Size).
+ */
+class DayArena {
+public:
+    static constexpr size_t Initial_Size  = size_t(1) << 20;
+    static constexpr size_t Max_Kept_Size = size_t(1) << 26;
+
+private:
+    /** Forwards to the heap and counts the allocated bytes */
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        size_t allocated = 0;
+
+    private:
+        void * do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void * p, size_t bytes, size_t alignment) override;
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource & other) const noexcept override;
+    };
+
+    std::unique_ptr<std::byte[]> m_buffer;
+    size_t m_buffer_size = 0;
+    CountingResource m_upstream;
+    std::optional<std::pmr::monotonic_buffer_resource> m_resource;
+
+public:
+    DayArena();
+    DayArena(const DayArena &) = delete;
+    DayArena & operator=(const DayArena &) = delete;
+
+    [[nodiscard]] std::pmr::memory_resource * resource() { return &*m_resource; }
+
+    /** Frees everything that was allocated in the arena. */
+    void reset();
+};
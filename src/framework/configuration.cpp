@@ -12,11 +12,13 @@ std::string InputConfig::to_string() const {
 }
 
 test::Expected::Expected(std::string line) {
-    if (const auto parameter = line.find("`"); parameter != std::string::npos) {
-        extra_parameter = std::stoi(line.substr(0, parameter));
+    for (size_t parameter = line.find('`') ; parameter != std::string::npos ; parameter = line.find('`')) {
+        extra_parameters.push_back(std::stoi(line.substr(0, parameter)));
         line = line.substr(parameter + 1);
     }
 
+    if (!extra_parameters.empty()) extra_parameter = extra_parameters.front();
+
     if (line == "?") {
         type  = Type::Wanted;
         value = "";
@@ -57,10 +59,10 @@ InputsConfig InputConfig::read_configuration(const int year) {
 
     InputsConfig configs;
 
-    std::ifstream file(path);
+    std::vector<std::string> lines;
+    read_input_lines(path, lines);
 
-    std::string line;
-    while (getline_cleaned(file, line)) {
+    for (const std::string & line : lines) {
         if (line.substr(0, 2) != "//") {
             configs.emplace_back(from_line(line, prefix));
         }
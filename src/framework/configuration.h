@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../advent_of_code.hpp"
+#include "arena.h"
+#include "inputs.h"
 #include <iostream>
 #include <fstream>
 #include <optional>
@@ -12,23 +14,6 @@
 
 #include "../colors.h"
 
-inline auto && getline_cleaned(std::ifstream & file, std::string & line) {
-    auto && b = std::getline(file, line);
-
-    if (b) {
-        auto it = line.begin();
-        while (it != line.end()) {
-            if (*it == '\r') {
-                it = line.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
-
-    return b;
-}
-
 struct InputConfig {
     using ExpectedType = std::pair<std::optional<int>, bool>;
 
@@ -47,7 +32,7 @@ struct InputConfig {
     static std::vector<InputConfig> read_configuration(int year);
     static InputConfig from_line(std::string_view line, const std::string & prefix);
 
-    template <typename Runner> std::optional<test::RunResult> run(Runner runner) const;
+    template <typename Runner> std::optional<test::RunResult> run(Runner runner, DayArena & arena) const;
 
     [[nodiscard]] std::string to_string() const;
 
@@ -60,30 +45,23 @@ struct InputConfig {
 
 template <typename Runner>
 // requires (std::is_invocable_r<Output, Fn, const std::vector<std::string> &, const DayExtraInfo &>::value)
-std::optional<test::RunResult> InputConfig::run(Runner runner) const {
+std::optional<test::RunResult> InputConfig::run(Runner runner, DayArena & arena) const {
     // Task
     std::vector<std::string> lines;
 
-    {
-        std::ifstream file(filename);
-
-        if (!file) {
-            std::cout << "No file " << filename << "\n";
-            return std::nullopt;
-        }
-
-        std::string line;
-        while (getline_cleaned(file, line)) {
-            lines.emplace_back(line);
-        }
-        // free file
+    if (!read_input_lines(filename, lines)) {
+        std::cout << "No file " << filename << "\n";
+        return std::nullopt;
     }
 
     DayExtraInfo day_extra_info {
-        .can_skip_part_A    = m_expected_part_1.type == test::Expected::Type::Ignore,
-        .part_a_extra_param = m_expected_part_1.extra_parameter,
-        .can_skip_part_B    = m_expected_part_2.type == test::Expected::Type::Ignore,
-        .part_b_extra_param = m_expected_part_2.extra_parameter
+        .can_skip_part_A     = m_expected_part_1.type == test::Expected::Type::Ignore,
+        .part_a_extra_param  = m_expected_part_1.extra_parameter,
+        .can_skip_part_B     = m_expected_part_2.type == test::Expected::Type::Ignore,
+        .part_b_extra_param  = m_expected_part_2.extra_parameter,
+        .part_a_extra_params = m_expected_part_1.extra_parameters,
+        .part_b_extra_params = m_expected_part_2.extra_parameters,
+        .memory_resource     = arena.resource()
     };
 
     if (!m_is_inline) {
@@ -92,6 +70,8 @@ std::optional<test::RunResult> InputConfig::run(Runner runner) const {
         const auto end = std::chrono::steady_clock::now();
         const auto elapsed_time = end - start;
 
+        arena.reset();
+
         return test::RunResult {
             .parts = std::array<std::optional<test::PartResult>, 2>({
                 test::PartResult::from(result.part_a, m_expected_part_1),
@@ -116,6 +96,7 @@ std::optional<test::RunResult> InputConfig::run(Runner runner) const {
             const std::string expect_b = splitter ? splitter() : "";
 
             Output result = runner(input, day_extra_info);
+            arena.reset();
 
             if (expect_a != "" && expect_a != "_") {
                 if (expect_a == result.part_a) {
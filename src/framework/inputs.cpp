@@ -0,0 +1,58 @@
+#include "inputs.h"
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <string_view>
+
+#ifdef BJ_EMBEDDED_INPUTS
+namespace {
+    struct EmbeddedFile {
+        const char * path;
+        const unsigned char * data;
+        std::size_t size;
+    };
+}
+
+// Generated by embed_inputs.sh: the Embedded_Files array
+#include "embedded_inputs.inc"
+#endif
+
+static void remove_carriage_returns(std::string & line) {
+    std::erase(line, '\r');
+}
+
+/** Splits like std::getline: no empty line after the last '\n' */
+[[maybe_unused]] static void split_lines(std::string_view content, std::vector<std::string> & lines) {
+    while (!content.empty()) {
+        const std::size_t end = content.find('\n');
+        std::string & line = lines.emplace_back(content.substr(0, end));
+        remove_carriage_returns(line);
+
+        if (end == std::string_view::npos) break;
+        content.remove_prefix(end + 1);
+    }
+}
+
+bool read_input_lines(const std::string & path, std::vector<std::string> & lines) {
+#ifdef BJ_EMBEDDED_INPUTS
+    const auto embedded = std::find_if(std::begin(Embedded_Files), std::end(Embedded_Files),
+        [&](const EmbeddedFile & file) { return path == file.path; }
+    );
+
+    if (embedded != std::end(Embedded_Files)) {
+        split_lines(std::string_view(reinterpret_cast<const char *>(embedded->data), embedded->size), lines);
+        return true;
+    }
+#endif
+
+    std::ifstream file(path);
+    if (!file) return false;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        remove_carriage_returns(line);
+        lines.emplace_back(line);
+    }
+
+    return true;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * Reads the lines of an input file, without their '\r'.
+ *
+ * In a binary built with `make embedded`, the files of inputs/ are served
+ * from a copy compiled in the binary, so no file is read at run time.
+ * Other files are read from the disk.
+ *
+ * Returns false if the file does not exist.
+ */
+bool read_input_lines(const std::string & path, std::vector<std::string> & lines);
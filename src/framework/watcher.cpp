@@ -0,0 +1,52 @@
+#include "watcher.h"
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+DirectoryWatcher::DirectoryWatcher(const std::string & directory) {
+    m_fd = inotify_init1(IN_CLOEXEC);
+    if (m_fd == -1) return;
+
+    if (inotify_add_watch(m_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) == -1) {
+        close(m_fd);
+        m_fd = -1;
+    }
+}
+
+DirectoryWatcher::~DirectoryWatcher() {
+    if (m_fd != -1) close(m_fd);
+}
+
+std::set<std::string> DirectoryWatcher::wait() {
+    static constexpr int Grouping_Delay_Ms = 50;
+
+    std::set<std::string> changed;
+    alignas(inotify_event) char buffer[4096];
+
+    // Block for the first event, then take the ones that follow it
+    int timeout = -1;
+    while (true) {
+        pollfd fd { m_fd, POLLIN, 0 };
+        if (poll(&fd, 1, timeout) <= 0) break;
+
+        const ssize_t length = read(m_fd, buffer, sizeof(buffer));
+        if (length <= 0) break;
+
+        for (ssize_t offset = 0 ; offset < length ;) {
+            const auto * event = reinterpret_cast<const inotify_event *>(buffer + offset);
+            if (event->len != 0) changed.emplace(event->name);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+        }
+
+        timeout = Grouping_Delay_Ms;
+    }
+
+    return changed;
+}
+#else
+DirectoryWatcher::DirectoryWatcher(const std::string &) {}
+DirectoryWatcher::~DirectoryWatcher() {}
+std::set<std::string> DirectoryWatcher::wait() { return {}; }
+#endif
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <set>
+#include <string>
+
+/**
+ * Waits for files of a directory to be written, with inotify.
+ *
+ * Only available on Linux: elsewhere, the watcher is never valid.
+ */
+class DirectoryWatcher {
+    int m_fd = -1;
+
+public:
+    explicit DirectoryWatcher(const std::string & directory);
+    DirectoryWatcher(const DirectoryWatcher &) = delete;
+    DirectoryWatcher & operator=(const DirectoryWatcher &) = delete;
+    ~DirectoryWatcher();
+
+    [[nodiscard]] bool is_valid() const noexcept { return m_fd != -1; }
+
+    /**
+     * Blocks until files are written or moved in the directory, and returns
+     * their names. Events that follow closely are grouped: an editor that
+     * saves several files gives one change.
+     */
+    [[nodiscard]] std::set<std::string> wait();
+};
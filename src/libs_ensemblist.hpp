@@ -1,7 +1,16 @@
 #pragma once
 
+#include "util/bipartite_matching.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
 #include <map>
 #include <set>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 /// Removes from lhs the elements that are not in rhs
 template <typename T, typename OtherTs>
@@ -38,6 +47,200 @@ std::set<T> & operator|=(std::set<T> & lhs, const OtherTs & rhs) {
 }
 
 
+
+namespace set {
+    /// A set stored as a bitset on the ids of its elements.
+    ///
+    /// Same interface as the std::set used with this library, but the set
+    /// operations work on 64 elements at once and size() is a popcount.
+    ///
+    /// Elements are integers or chars, used as bit indexes: they must be non
+    /// negative and small. Other values are first interned into dense ids,
+    /// for example with a bj::SymbolTable.
+    template <typename T>
+    requires (std::is_integral_v<T>)
+    class DenseSet {
+        using Word = std::uint64_t;
+        static constexpr size_t Word_Bits = 64;
+
+        std::vector<Word> m_words;
+
+        [[nodiscard]] static size_t id_of(T value) noexcept { return static_cast<std::make_unsigned_t<T>>(value); }
+        [[nodiscard]] static T value_of(size_t id) noexcept { return static_cast<T>(id); }
+
+        /// Removes the trailing empty words, so equal sets have equal words
+        void trim() {
+            while (!m_words.empty() && m_words.back() == 0) m_words.pop_back();
+        }
+
+    public:
+        using value_type = T;
+        using key_type   = T;
+
+        class iterator {
+            const std::vector<Word> * m_words = nullptr;
+            size_t m_word = 0;
+            Word   m_rest = 0;
+
+            void skip_empty_words() {
+                while (m_rest == 0 && m_word + 1 < m_words->size()) {
+                    ++m_word;
+                    m_rest = (*m_words)[m_word];
+                }
+            }
+
+        public:
+            using value_type        = T;
+            using difference_type   = std::ptrdiff_t;
+            using iterator_category = std::forward_iterator_tag;
+
+            iterator() = default;
+            iterator(const std::vector<Word> & words, bool at_end) : m_words(&words) {
+                if (at_end || words.empty()) {
+                    m_word = words.size();
+                } else {
+                    m_rest = words[0];
+                    skip_empty_words();
+                    if (m_rest == 0) m_word = words.size();
+                }
+            }
+
+            [[nodiscard]] T operator*() const {
+                return value_of(m_word * Word_Bits + static_cast<size_t>(std::countr_zero(m_rest)));
+            }
+
+            iterator & operator++() {
+                m_rest &= m_rest - 1;
+                skip_empty_words();
+                if (m_rest == 0) m_word = m_words->size();
+                return *this;
+            }
+
+            iterator operator++(int) { iterator copy = *this; ++*this; return copy; }
+
+            [[nodiscard]] bool operator==(const iterator & other) const noexcept {
+                return m_word == other.m_word && m_rest == other.m_rest;
+            }
+        };
+
+        using const_iterator = iterator;
+
+        DenseSet() = default;
+
+        DenseSet(std::initializer_list<T> values) {
+            for (const T value : values) insert(value);
+        }
+
+        template <typename It>
+        DenseSet(It first, It last) {
+            for (; first != last ; ++first) insert(*first);
+        }
+
+        bool insert(T value) {
+            const size_t id = id_of(value);
+            if (id / Word_Bits >= m_words.size()) m_words.resize(id / Word_Bits + 1, 0);
+
+            Word & word = m_words[id / Word_Bits];
+            const Word bit = Word(1) << (id % Word_Bits);
+            const bool inserted = (word & bit) == 0;
+            word |= bit;
+            return inserted;
+        }
+
+        template <typename... Args>
+        bool emplace(Args &&... args) {
+            return insert(T(std::forward<Args>(args)...));
+        }
+
+        size_t erase(T value) {
+            if (!contains(value)) return 0;
+            const size_t id = id_of(value);
+            m_words[id / Word_Bits] &= ~(Word(1) << (id % Word_Bits));
+            trim();
+            return 1;
+        }
+
+        [[nodiscard]] bool contains(T value) const {
+            const size_t id = id_of(value);
+            if (id / Word_Bits >= m_words.size()) return false;
+            return (m_words[id / Word_Bits] >> (id % Word_Bits)) & 1;
+        }
+
+        [[nodiscard]] size_t count(T value) const { return contains(value) ? 1 : 0; }
+
+        [[nodiscard]] size_t size() const noexcept {
+            size_t total = 0;
+            for (const Word word : m_words) total += static_cast<size_t>(std::popcount(word));
+            return total;
+        }
+
+        [[nodiscard]] bool empty() const noexcept { return m_words.empty(); }
+        void clear() noexcept { m_words.clear(); }
+
+        [[nodiscard]] iterator begin() const { return iterator(m_words, false); }
+        [[nodiscard]] iterator end()   const { return iterator(m_words, true); }
+
+        [[nodiscard]] bool operator==(const DenseSet & other) const = default;
+
+        /// Removes from this the elements that are not in rhs
+        DenseSet & operator&=(const DenseSet & rhs) {
+            m_words.resize(std::min(m_words.size(), rhs.m_words.size()));
+            for (size_t i = 0 ; i != m_words.size() ; ++i) m_words[i] &= rhs.m_words[i];
+            trim();
+            return *this;
+        }
+
+        /// Removes from this the elements in rhs
+        DenseSet & operator^=(const DenseSet & rhs) {
+            const size_t common = std::min(m_words.size(), rhs.m_words.size());
+            for (size_t i = 0 ; i != common ; ++i) m_words[i] &= ~rhs.m_words[i];
+            trim();
+            return *this;
+        }
+
+        DenseSet & operator|=(const DenseSet & rhs) {
+            if (rhs.m_words.size() > m_words.size()) m_words.resize(rhs.m_words.size(), 0);
+            for (size_t i = 0 ; i != rhs.m_words.size() ; ++i) m_words[i] |= rhs.m_words[i];
+            return *this;
+        }
+
+        /// Removes the elements that satisfy the predicate
+        template <typename Predicate>
+        friend size_t erase_if(DenseSet & self, Predicate predicate) {
+            size_t removed = 0;
+            for (size_t w = 0 ; w != self.m_words.size() ; ++w) {
+                for (Word rest = self.m_words[w] ; rest != 0 ; rest &= rest - 1) {
+                    const int bit = std::countr_zero(rest);
+                    if (predicate(value_of(w * Word_Bits + static_cast<size_t>(bit)))) {
+                        self.m_words[w] &= ~(Word(1) << bit);
+                        ++removed;
+                    }
+                }
+            }
+            self.trim();
+            return removed;
+        }
+    };
+
+    /// result = lhs intersection rhs
+    template <typename T>
+    DenseSet<T> intersection(DenseSet<T> lhs, const DenseSet<T> & rhs) {
+        return lhs &= rhs;
+    }
+
+    /// result = lhs U rhs
+    template <typename T>
+    DenseSet<T> union_(DenseSet<T> lhs, const DenseSet<T> & rhs) {
+        return lhs |= rhs;
+    }
+
+    /// result = lhs - rhs
+    template <typename T>
+    DenseSet<T> difference(DenseSet<T> lhs, const DenseSet<T> & rhs) {
+        return lhs ^= rhs;
+    }
+}
+
 namespace set {
     /// result = lhs intersection rhs
     template <typename T>
@@ -71,9 +274,9 @@ namespace set {
         return set;
     }
 
-    template <typename Ts>
-    auto to_set(const Ts & map) {
-        std::set<typename Ts::key_type> retval;
+    template <typename Ts, typename Set = std::set<typename Ts::key_type>>
+    Set to_set(const Ts & map) {
+        Set retval;
 
         for (const auto & [key, _value] : map) {
             retval.insert(key);
@@ -88,28 +291,85 @@ namespace set {
     /// using the fact that 1 key is associated to only one possible value
     /// this function removes from every N possibles values the values that
     /// are already bounded to one key.
-    template <typename Key, typename Value>
-    void resolve_key_to_value(std::map<Key, std::set<Value>> & to_solve) {
-        // O(n²) complexity
-        std::set<Value> singletons;
-        for (const auto & [key, values] : to_solve) {
-            if (values.size() == 1) singletons.insert(*values.begin());
-        }
-        
-        size_t singletons_size;
-        do {
-            singletons_size = singletons.size();
-
-            for (auto & [key, values] : to_solve) {
-                if (values.size() == 1) continue;
-                
-                values ^= singletons;
-
-                if (values.size() == 1) {
-                    singletons.insert(*values.begin());
-                }
+    ///
+    /// The keys bounded to one value are processed from a worklist, so every
+    /// (key, value) pair is visited once. If some keys still have several
+    /// values when the worklist is empty, they are given the values of a
+    /// maximum bipartite matching.
+    ///
+    /// Returns true if every key ends up with exactly one value, and no two
+    /// keys with the same value.
+    template <typename Key, typename Values>
+    [[nodiscard]] bool resolve_key_to_value(std::map<Key, Values> & to_solve) {
+        using Value = std::decay_t<decltype(*to_solve.begin()->second.begin())>;
+
+        std::vector<Values *> keys;
+        std::map<Value, std::vector<size_t>> holders;   // value -> keys that may have it
+        for (auto & [key, values] : to_solve) {
+            for (const auto & value : values) holders[value].push_back(keys.size());
+            keys.push_back(&values);
+        }
+
+        std::vector<size_t> worklist;
+        for (size_t key = 0 ; key != keys.size() ; ++key) {
+            if (keys[key]->size() == 1) worklist.push_back(key);
+        }
+
+        while (!worklist.empty()) {
+            const size_t key = worklist.back();
+            worklist.pop_back();
+
+            const auto holders_it = holders.find(*keys[key]->begin());
+            for (const size_t other : holders_it->second) {
+                Values & values = *keys[other];
+                if (other == key || values.size() <= 1) continue;
+
+                values.erase(holders_it->first);
+                if (values.size() == 1) worklist.push_back(other);
             }
 
-        } while (singletons_size != singletons.size());
+            holders_it->second.clear();
+        }
+
+        // Propagation stalled: match the remaining keys with the remaining values
+        std::vector<size_t> unresolved;
+        for (size_t key = 0 ; key != keys.size() ; ++key) {
+            if (keys[key]->size() > 1) unresolved.push_back(key);
+        }
+
+        // Contradictory inputs can leave keys with no value, or several keys
+        // reduced to the same value
+        const auto is_one_to_one = [&]() {
+            std::set<Value> taken;
+            return std::all_of(keys.begin(), keys.end(), [&](const Values * values) {
+                return values->size() == 1 && taken.insert(*values->begin()).second;
+            });
+        };
+
+        if (unresolved.empty()) return is_one_to_one();
+
+        std::map<Value, size_t> value_ids;
+        std::vector<const Value *> id_to_value;
+        std::vector<std::vector<size_t>> adjacency;
+        for (const size_t key : unresolved) {
+            std::vector<size_t> & neighbours = adjacency.emplace_back();
+            for (const auto & value : *keys[key]) {
+                const auto [it, inserted] = value_ids.try_emplace(value, id_to_value.size());
+                if (inserted) id_to_value.push_back(&it->first);
+                neighbours.push_back(it->second);
+            }
+        }
+
+        const std::vector<size_t> matching = bj::maximum_bipartite_matching(adjacency, id_to_value.size());
+
+        for (size_t i = 0 ; i != unresolved.size() ; ++i) {
+            if (matching[i] == bj::No_Match) continue;
+
+            Values single;
+            single.insert(*id_to_value[matching[i]]);
+            *keys[unresolved[i]] = std::move(single);
+        }
+
+        return is_one_to_one();
     }
 }
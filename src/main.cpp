@@ -1,11 +1,19 @@
 #include <iostream>
 #include "framework/configuration.h"
+#include "framework/watcher.h"
 #include "2015/days.hpp"
 #include "2016/days.hpp"
 #include "2020/days.hpp"
 #include <algorithm>
 #include "colors.h"
+#include "util/big_buffer.hpp"
+#include "util/isa.hpp"
+#include "util/vm.hpp"
 #include <map>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
 
 static auto get_all_handlers() {
     std::map<int, std::array<DayEntryPoint *, 25>> map;
@@ -24,13 +32,16 @@ static auto highest_day(const Map & m) {
 
 void print(const InputConfig & config, const std::optional<test::RunResult> & r);
 
-void dispatch(const InputConfig & config, test::Score & ts, const std::array<DayEntryPoint *, 25> & days) {
+std::optional<test::RunResult> dispatch(const InputConfig & config, test::Score & ts, const std::array<DayEntryPoint *, 25> & days, DayArena & arena) {
     if (DayEntryPoint * day = days[config.day - 1]) {
-        std::optional<test::RunResult> r = config.run(day);
+        std::optional<test::RunResult> r = config.run(day, arena);
+        bj::huge_pages::collect();
         print(config, r);
         ts += r;
+        return r;
     } else {
         print(config, std::nullopt);
+        return std::nullopt;
     }
 }
 
@@ -79,12 +90,132 @@ void print(const InputConfig & config, const std::optional<test::RunResult> & r)
     std::cout << RST "\n";
 }
 
+struct RunnerOptions {
+    /** Run the days again when their inputs change */
+    bool watch = false;
+};
+
+/**
+ * Applies the --flags and removes them from the arguments.
+ * Returns false if a flag is unknown.
+ */
+static bool read_flags(std::vector<std::string_view> & arguments, RunnerOptions & options) {
+    std::vector<std::string_view> positionals;
+
+    for (const std::string_view argument : arguments) {
+        if (!argument.starts_with("--")) {
+            positionals.push_back(argument);
+        } else if (argument == "--trace-vm") {
+            bj::vm::trace = true;
+        } else if (argument == "--watch") {
+#if defined(BJ_EMBEDDED_INPUTS)
+            // The inputs are read from the binary, not from the watched files
+            (void) options;
+            std::cerr << "--watch is not available with embedded inputs\n";
+            return false;
+#else
+            options.watch = true;
+#endif
+        } else if (argument.starts_with("--isa=")) {
+            const std::string_view name = argument.substr(6);
+            const std::optional<bj::isa::Level> level = bj::isa::from_name(name);
+
+            if (!level) {
+                std::cerr << "Unknown instruction set: " << name << '\n';
+                return false;
+            } else if (!bj::isa::force(*level)) {
+                std::cerr << "Instruction set not supported by this processor: " << name << '\n';
+                return false;
+            }
+        } else {
+            std::cerr << "Unknown option: " << argument << '\n';
+            return false;
+        }
+    }
+
+    arguments = std::move(positionals);
+    return true;
+}
+
+/**
+ * Runs the inputs of the required day (0 = every day), then waits for
+ * files of inputs/<year>/ to change and runs again the inputs that
+ * changed, until killed. The memory arena and the thread pool are kept
+ * from one run to the other, but every run reads and parses its input
+ * again: the days do not expose their parsed state.
+ */
+static int watch(int year, int required_day, const std::array<DayEntryPoint *, 25> & days) {
+    const std::string directory = "inputs/" + std::to_string(year);
+    DirectoryWatcher watcher(directory);
+    if (!watcher.is_valid()) {
+        std::cerr << "Can not watch " << directory << '\n';
+        return 1;
+    }
+
+    DayArena arena;
+    std::vector<InputConfig> configs = InputConfig::read_configuration(year);
+
+    // Time of the last run of each (day, input)
+    std::map<std::pair<int, std::string>, std::chrono::duration<double>> last_times;
+
+    const auto run = [&](const InputConfig & config) {
+        if (config.day != required_day && required_day != 0) return;
+
+        test::Score score;
+        const std::optional<test::RunResult> result = dispatch(config, score, days, arena);
+        if (!result) return;
+
+        const auto key = std::make_pair(config.day, config.filename);
+        if (const auto previous = last_times.find(key); previous != last_times.end()) {
+            const auto to_ms = [](std::chrono::duration<double> time) { return static_cast<int>(time.count() * 1000); };
+            char buffer[128];
+            std::sprintf(buffer, "   %+d ms (previous run: %d ms)", to_ms(result->elapsed_time) - to_ms(previous->second), to_ms(previous->second));
+            std::cout << buffer << '\n';
+        }
+        last_times[key] = result->elapsed_time;
+    };
+
+    for (const InputConfig & config : configs) run(config);
+
+    while (true) {
+        std::cout << "\x1B[1m" KCYN "Watching " << directory << RST << std::endl;
+        const std::set<std::string> changed = watcher.wait();
+        if (changed.empty()) continue;
+        std::cout << '\n';
+
+        if (changed.contains("config.txt")) {
+            // Only the lines that changed are run
+            std::vector<InputConfig> new_configs = InputConfig::read_configuration(year);
+            for (const InputConfig & config : new_configs) {
+                const bool is_new = std::none_of(configs.begin(), configs.end(),
+                    [&](const InputConfig & old) { return old.to_string() == config.to_string(); }
+                );
+                const bool input_changed = changed.contains(config.filename.substr(directory.size() + 1));
+                if (is_new || input_changed) run(config);
+            }
+            configs = std::move(new_configs);
+        } else {
+            for (const InputConfig & config : configs) {
+                if (changed.contains(config.filename.substr(directory.size() + 1))) run(config);
+            }
+        }
+    }
+}
+
 int main(int argc, const char * argv[]) {
     const auto handlers = get_all_handlers();
 
-    const int year = argc > 2 ? std::stoi(argv[1]) : 2016; //highest_day(handlers);
-    const int day  = argc > 2 ? std::stoi(argv[2]) :
-                     argc > 1 ? std::stoi(argv[1]) : -2;
+    std::vector<std::string_view> args(argv, argv + argc);
+    RunnerOptions options;
+    if (!read_flags(args, options)) return 1;
+
+    // ./main --watch year
+    if (options.watch && args.size() == 2) args.push_back("0");
+
+    const int nb_args = static_cast<int>(args.size());
+    const int year = nb_args > 2 ? std::stoi(std::string(args[1])) : 2016; //highest_day(handlers);
+    const int day  = nb_args > 2 ? std::stoi(std::string(args[2])) :
+                     nb_args > 1 ? std::stoi(std::string(args[1])) : -2;
 
     const auto handlers_it = handlers.find(year);
     if (handlers_it == handlers.end()) {
@@ -92,11 +223,16 @@ int main(int argc, const char * argv[]) {
         return 1;
     }
 
+    if (options.watch) {
+        return watch(year, day != -2 ? day : 0, handlers_it->second);
+    }
+
     auto configs = InputConfig::read_configuration(year);
 
     const int required_day = day != -2 ? day : InputConfig::last_day(configs);
 
     test::Score testScore;
+    DayArena arena;
 
     std::optional<int> last_seen_day = std::nullopt;
 
@@ -107,7 +243,7 @@ int main(int argc, const char * argv[]) {
             }
             last_seen_day = config.day;
 
-            dispatch(config, testScore, handlers_it->second);
+            dispatch(config, testScore, handlers_it->second, arena);
         }
     }
 
@@ -124,5 +260,11 @@ int main(int argc, const char * argv[]) {
               << "\n" KRED "Failed = " << testScore.failed << RST << '\n'
               << "\n\x1B[1m" KCYN     "Time = " << time << RST << '\n';
 
+    const bj::huge_pages::Stats & huge_pages = bj::huge_pages::stats();
+    if (huge_pages.buffers != 0) {
+        std::cout << "Huge pages = " << (huge_pages.huge_bytes >> 20) << " MB of "
+                  << (huge_pages.bytes >> 20) << " MB in " << huge_pages.buffers << " big buffers\n";
+    }
+
     return 0;
 }
@@ -0,0 +1,289 @@
+#pragma once
+
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+// Large fixed size arrays for the solvers that walk megabytes of memory in
+// a random order (linked lists in an array, last seen tables...). Such
+// loops are bound by the TLB: with 4 KB pages, nearly every access misses.
+//
+// bj::BigBuffer<uint32_t> next(1'000'000);
+//
+// The buffer is aligned on a cache line. On Linux, buffers of at least one
+// huge page are mapped on their own, preferably on reserved huge pages
+// (MAP_HUGETLB), else with transparent huge pages (MADV_HUGEPAGE). The
+// pages are touched once when the buffer is filled, by the threads of the
+// shared pool if asked, so they are allocated on the NUMA node of the
+// threads that use them.
+//
+// Reading how much of a buffer ended on huge pages is slow, so a freed
+// mapped buffer is only retired: it is measured and unmapped by
+// bj::huge_pages::collect(), that the runner calls after each timed day.
+
+namespace bj {
+    namespace huge_pages {
+        static constexpr std::size_t Cache_Line = 64;
+        static constexpr std::size_t Page_Size  = std::size_t(2) << 20;
+
+        /** What the big buffers got, since the start of the program */
+        struct Stats {
+            std::atomic<std::size_t> buffers    { 0 };
+            std::atomic<std::size_t> bytes      { 0 };
+            /** Bytes that were on huge pages when the buffer was collected */
+            std::atomic<std::size_t> huge_bytes { 0 };
+        };
+
+        inline Stats & stats() {
+            static Stats stats;
+            return stats;
+        }
+
+        /**
+         * Number of bytes of the mapping that starts at address that are on
+         * transparent huge pages, read from /proc/self/smaps
+         */
+        [[nodiscard]] inline std::size_t transparent_bytes(const void * address) {
+#if defined(__linux__)
+            std::FILE * smaps = std::fopen("/proc/self/smaps", "r");
+            if (!smaps) return 0;
+
+            const auto wanted = reinterpret_cast<std::uintptr_t>(address);
+            bool in_mapping = false;
+            std::size_t kilobytes = 0;
+            char line[256];
+
+            while (std::fgets(line, sizeof(line), smaps)) {
+                unsigned long begin = 0;
+                unsigned long end   = 0;
+                if (std::sscanf(line, "%lx-%lx ", &begin, &end) == 2) {
+                    if (in_mapping) break;
+                    in_mapping = begin <= wanted && wanted < end;
+                } else if (in_mapping && std::strncmp(line, "AnonHugePages:", 14) == 0) {
+                    std::sscanf(line + 14, "%zu", &kilobytes);
+                    break;
+                }
+            }
+
+            std::fclose(smaps);
+            return kilobytes * 1024;
+#else
+            (void) address;
+            return 0;
+#endif
+        }
+
+        /** A mapping of a freed buffer, waiting to be measured and unmapped */
+        struct Retired {
+            void * address;
+            std::size_t bytes;
+            bool on_hugetlb;
+        };
+
+        /**
+         * Above this number of retired bytes, the retired mappings are
+         * collected when a buffer is freed, even in a timed region, so a
+         * solver that frees big buffers in a loop does not exhaust memory
+         */
+        static constexpr std::size_t Max_Retired_Bytes = std::size_t(1) << 30;
+
+        struct RetiredList {
+            std::mutex mutex;
+            std::vector<Retired> mappings;
+            std::size_t bytes = 0;
+        };
+
+        inline RetiredList & retired() {
+            static RetiredList retired;
+            return retired;
+        }
+
+        /**
+         * Measures the retired mappings, adds them to the stats and unmaps
+         * them. Call it outside of the timed regions.
+         */
+        inline void collect() {
+            RetiredList & list = retired();
+            std::vector<Retired> mappings;
+            {
+                std::lock_guard lock(list.mutex);
+                mappings.swap(list.mappings);
+                list.bytes = 0;
+            }
+
+            Stats & stats = huge_pages::stats();
+            for (const Retired & mapping : mappings) {
+                const std::size_t huge = mapping.on_hugetlb ? mapping.bytes : transparent_bytes(mapping.address);
+                stats.buffers    += 1;
+                stats.bytes      += mapping.bytes;
+                stats.huge_bytes += std::min(huge, mapping.bytes);
+#if defined(__linux__)
+                ::munmap(mapping.address, mapping.bytes);
+#endif
+            }
+        }
+
+        /** Hands a mapping over to the next collect() */
+        inline void retire(void * address, std::size_t bytes, bool on_hugetlb) {
+            RetiredList & list = retired();
+            bool must_collect = false;
+            {
+                std::lock_guard lock(list.mutex);
+                list.mappings.push_back(Retired { address, bytes, on_hugetlb });
+                list.bytes += bytes;
+                must_collect = list.bytes > Max_Retired_Bytes;
+            }
+
+            if (must_collect) collect();
+        }
+    }
+
+    /** How a BigBuffer is allocated */
+    struct BigBufferOptions {
+        /** Try to put the buffer on huge pages */
+        bool huge_pages = true;
+        /** Fill the buffer from the threads of the shared pool */
+        bool parallel_first_touch = false;
+    };
+
+    /**
+     * A fixed size array of trivial values, for buffers of several
+     * megabytes. Not copyable.
+     */
+    template <typename T>
+    class BigBuffer {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+            "The content of a big buffer is never constructed nor destroyed");
+
+        T * m_data = nullptr;
+        std::size_t m_size = 0;
+        std::size_t m_mapped_bytes = 0;     // 0 if allocated with new
+        bool m_on_hugetlb = false;
+
+        void allocate(const BigBufferOptions & options) {
+            const std::size_t bytes = std::max<std::size_t>(m_size * sizeof(T), 1);
+
+#if defined(__linux__)
+            if (options.huge_pages && bytes >= huge_pages::Page_Size) {
+                const std::size_t rounded = (bytes + huge_pages::Page_Size - 1) / huge_pages::Page_Size * huge_pages::Page_Size;
+
+                void * hugetlb = ::mmap(nullptr, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+                if (hugetlb != MAP_FAILED) {
+                    m_data = static_cast<T *>(hugetlb);
+                    m_mapped_bytes = rounded;
+                    m_on_hugetlb = true;
+                    return;
+                }
+
+                // Transparent huge pages are only used on 2 MB aligned
+                // ranges: map more and trim
+                const std::size_t oversized = rounded + huge_pages::Page_Size;
+                void * mapped = ::mmap(nullptr, oversized, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (mapped != MAP_FAILED) {
+                    const auto begin   = reinterpret_cast<std::uintptr_t>(mapped);
+                    const auto aligned = (begin + huge_pages::Page_Size - 1) / huge_pages::Page_Size * huge_pages::Page_Size;
+                    const std::size_t before = aligned - begin;
+                    const std::size_t after  = oversized - before - rounded;
+                    if (before != 0) ::munmap(mapped, before);
+                    if (after  != 0) ::munmap(reinterpret_cast<void *>(aligned + rounded), after);
+
+                    ::madvise(reinterpret_cast<void *>(aligned), rounded, MADV_HUGEPAGE);
+
+                    m_data = reinterpret_cast<T *>(aligned);
+                    m_mapped_bytes = rounded;
+                    return;
+                }
+            }
+#endif
+
+            const std::size_t alignment = std::max(huge_pages::Cache_Line, alignof(T));
+            m_data = static_cast<T *>(::operator new(bytes, std::align_val_t(alignment)));
+        }
+
+        void release() noexcept {
+            if (!m_data) return;
+
+#if defined(__linux__)
+            if (m_mapped_bytes != 0) {
+                // Measured and unmapped later, out of the timed region
+                try {
+                    huge_pages::retire(m_data, m_mapped_bytes, m_on_hugetlb);
+                } catch (...) {
+                    ::munmap(m_data, m_mapped_bytes);
+                }
+                m_data = nullptr;
+                return;
+            }
+#endif
+
+            const std::size_t alignment = std::max(huge_pages::Cache_Line, alignof(T));
+            ::operator delete(m_data, std::align_val_t(alignment));
+            m_data = nullptr;
+        }
+
+    public:
+        BigBuffer(std::size_t size, const T & value = T{}, const BigBufferOptions & options = {})
+        : m_size(size) {
+            allocate(options);
+
+            // First touch: the pages are allocated here
+            constexpr std::size_t Chunk = std::max<std::size_t>(huge_pages::Page_Size / sizeof(T), 1);
+            const std::size_t nb_chunks = (m_size + Chunk - 1) / Chunk;
+            const auto fill_chunk = [&](std::size_t chunk) {
+                std::fill(m_data + chunk * Chunk, m_data + std::min(m_size, (chunk + 1) * Chunk), value);
+            };
+
+            if (options.parallel_first_touch) {
+                ThreadPool::shared().parallel_for(nb_chunks, [&](std::size_t chunk) { fill_chunk(chunk); });
+            } else {
+                for (std::size_t chunk = 0 ; chunk != nb_chunks ; ++chunk) fill_chunk(chunk);
+            }
+        }
+
+        BigBuffer(const BigBuffer &) = delete;
+        BigBuffer & operator=(const BigBuffer &) = delete;
+
+        BigBuffer(BigBuffer && other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)),
+          m_mapped_bytes(std::exchange(other.m_mapped_bytes, 0)), m_on_hugetlb(other.m_on_hugetlb) {}
+
+        BigBuffer & operator=(BigBuffer && other) noexcept {
+            if (this != &other) {
+                release();
+                m_data         = std::exchange(other.m_data, nullptr);
+                m_size         = std::exchange(other.m_size, 0);
+                m_mapped_bytes = std::exchange(other.m_mapped_bytes, 0);
+                m_on_hugetlb   = other.m_on_hugetlb;
+            }
+            return *this;
+        }
+
+        ~BigBuffer() { release(); }
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+        [[nodiscard]] T * data() noexcept { return m_data; }
+        [[nodiscard]] const T * data() const noexcept { return m_data; }
+
+        [[nodiscard]] T & operator[](std::size_t i) noexcept { return m_data[i]; }
+        [[nodiscard]] const T & operator[](std::size_t i) const noexcept { return m_data[i]; }
+
+        [[nodiscard]] T * begin() noexcept { return m_data; }
+        [[nodiscard]] T * end() noexcept { return m_data + m_size; }
+        [[nodiscard]] const T * begin() const noexcept { return m_data; }
+        [[nodiscard]] const T * end() const noexcept { return m_data + m_size; }
+    };
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace bj {
+    /** Marks a vertex that has no partner in a matching */
+    inline constexpr std::size_t No_Match = std::numeric_limits<std::size_t>::max();
+
+    /**
+     * Hopcroft-Karp maximum matching of a bipartite graph, in
+     * O(E sqrt(V)).
+     *
+     * adjacency[left] lists the right vertices, in [0, nb_right[, that the
+     * left vertex can be matched with. Returns for each left vertex its
+     * partner, or No_Match.
+     */
+    [[nodiscard]] inline std::vector<std::size_t> maximum_bipartite_matching(
+        const std::vector<std::vector<std::size_t>> & adjacency,
+        std::size_t nb_right
+    ) {
+        constexpr std::size_t Infinite = std::numeric_limits<std::size_t>::max();
+
+        const std::size_t nb_left = adjacency.size();
+        std::vector<std::size_t> match_left(nb_left, No_Match);
+        std::vector<std::size_t> match_right(nb_right, No_Match);
+        std::vector<std::size_t> distance(nb_left);
+        std::vector<std::size_t> queue;
+
+        // Layers the graph from the free left vertices, true if an
+        // augmenting path exists
+        const auto build_layers = [&]() {
+            queue.clear();
+            for (std::size_t left = 0 ; left != nb_left ; ++left) {
+                if (match_left[left] == No_Match) {
+                    distance[left] = 0;
+                    queue.push_back(left);
+                } else {
+                    distance[left] = Infinite;
+                }
+            }
+
+            bool found_free_right = false;
+            for (std::size_t i = 0 ; i != queue.size() ; ++i) {
+                const std::size_t left = queue[i];
+                for (const std::size_t right : adjacency[left]) {
+                    const std::size_t next = match_right[right];
+                    if (next == No_Match) {
+                        found_free_right = true;
+                    } else if (distance[next] == Infinite) {
+                        distance[next] = distance[left] + 1;
+                        queue.push_back(next);
+                    }
+                }
+            }
+
+            return found_free_right;
+        };
+
+        // Augments along a shortest path that starts from left
+        const auto augment = [&](const auto & self, std::size_t left) -> bool {
+            for (const std::size_t right : adjacency[left]) {
+                const std::size_t next = match_right[right];
+                if (next == No_Match || (distance[next] == distance[left] + 1 && self(self, next))) {
+                    match_left[left]   = right;
+                    match_right[right] = left;
+                    return true;
+                }
+            }
+
+            distance[left] = Infinite;
+            return false;
+        };
+
+        while (build_layers()) {
+            for (std::size_t left = 0 ; left != nb_left ; ++left) {
+                if (match_left[left] == No_Match) augment(augment, left);
+            }
+        }
+
+        return match_left;
+    }
+}
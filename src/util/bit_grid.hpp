@@ -0,0 +1,289 @@
+#pragma once
+
+#include "isa.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace bj {
+    /**
+     * A 2D grid of booleans, packed in 64 bits words.
+     *
+     * Each row is stored on its own words, so operations on rows and
+     * rectangles are done 64 cells at a time. Bit x of a row is the cell of
+     * column x. Bits after the width of the grid are always 0.
+     *
+     * Coordinates are (x = column, y = row), like bj::Position.
+     */
+    class BitGrid {
+    public:
+        using Word = std::uint64_t;
+        static constexpr std::size_t Word_Bits = 64;
+
+    private:
+        std::size_t m_width;
+        std::size_t m_height;
+        std::size_t m_words_per_row;
+        std::vector<Word> m_words;
+
+        [[nodiscard]] static constexpr std::size_t words_for(std::size_t width) noexcept {
+            return (width + Word_Bits - 1) / Word_Bits;
+        }
+
+        /** Bits [from, to[ of a word */
+        [[nodiscard]] static constexpr Word mask(std::size_t from, std::size_t to) noexcept {
+            const Word high = to == Word_Bits ? ~Word(0) : (Word(1) << to) - 1;
+            return high & ~((Word(1) << from) - 1);
+        }
+
+        [[nodiscard]] Word * row_words(std::size_t y) noexcept { return m_words.data() + y * m_words_per_row; }
+        [[nodiscard]] const Word * row_words(std::size_t y) const noexcept { return m_words.data() + y * m_words_per_row; }
+
+        /** Clears the bits after the width on every row */
+        void trim() noexcept {
+            const std::size_t used = m_width % Word_Bits;
+            if (used == 0) return;
+
+            const Word keep = mask(0, used);
+            for (std::size_t y = 0 ; y != m_height ; ++y) {
+                row_words(y)[m_words_per_row - 1] &= keep;
+            }
+        }
+
+        /** Applies word = op(word, other word) on the whole grid */
+        template <typename Operation>
+        void apply_words(const BitGrid & other, Operation op) noexcept {
+            Word * const words = m_words.data();
+            const Word * const others = other.m_words.data();
+            const std::size_t size = m_words.size();
+
+            bj::isa::dispatch([&]() {
+                for (std::size_t i = 0 ; i != size ; ++i) words[i] = op(words[i], others[i]);
+            });
+        }
+
+        /** Applies word = op(word, mask) on the cells [left, right] of the rows [top, bottom] */
+        template <typename Operation>
+        void apply_rectangle(std::size_t left, std::size_t top, std::size_t right, std::size_t bottom, Operation op) noexcept {
+            const std::size_t first_word = left / Word_Bits;
+            const std::size_t last_word  = right / Word_Bits;
+            const Word first_mask = mask(left % Word_Bits, Word_Bits);
+            const Word last_mask  = mask(0, right % Word_Bits + 1);
+
+            bj::isa::dispatch([&]() {
+                for (std::size_t y = top ; y <= bottom ; ++y) {
+                    Word * row = row_words(y);
+
+                    if (first_word == last_word) {
+                        row[first_word] = op(row[first_word], first_mask & last_mask);
+                        continue;
+                    }
+
+                    row[first_word] = op(row[first_word], first_mask);
+                    for (std::size_t w = first_word + 1 ; w < last_word ; ++w) {
+                        row[w] = op(row[w], ~Word(0));
+                    }
+                    row[last_word] = op(row[last_word], last_mask);
+                }
+            });
+        }
+
+        /** Returns the bits [from, from + 64[ of a row, 0 when out of the row */
+        [[nodiscard]] Word extract(const Word * row, std::ptrdiff_t from) const noexcept {
+            const std::ptrdiff_t words = static_cast<std::ptrdiff_t>(m_words_per_row);
+            const std::ptrdiff_t word  = from >= 0 ? from / 64 : (from - 63) / 64;
+            const unsigned       shift = static_cast<unsigned>(from - word * 64);
+
+            const Word low  = word >= 0 && word < words ? row[word] : 0;
+            if (shift == 0) return low;
+
+            const Word high = word + 1 >= 0 && word + 1 < words ? row[word + 1] : 0;
+            return (low >> shift) | (high << (Word_Bits - shift));
+        }
+
+    public:
+        BitGrid(std::size_t width, std::size_t height)
+        : m_width(width), m_height(height), m_words_per_row(words_for(width)),
+          m_words(m_words_per_row * height, 0) {}
+
+        [[nodiscard]] std::size_t width()  const noexcept { return m_width; }
+        [[nodiscard]] std::size_t height() const noexcept { return m_height; }
+
+        [[nodiscard]] bool operator==(const BitGrid & other) const = default;
+
+        // ==== Single cells
+
+        [[nodiscard]] bool get(std::size_t x, std::size_t y) const noexcept {
+            return (row_words(y)[x / Word_Bits] >> (x % Word_Bits)) & 1;
+        }
+
+        void set(std::size_t x, std::size_t y, bool value = true) noexcept {
+            Word & word = row_words(y)[x / Word_Bits];
+            const Word bit = Word(1) << (x % Word_Bits);
+            if (value) word |= bit; else word &= ~bit;
+        }
+
+        void toggle(std::size_t x, std::size_t y) noexcept {
+            row_words(y)[x / Word_Bits] ^= Word(1) << (x % Word_Bits);
+        }
+
+        // ==== Rows
+
+        /** Sets the row y from a text: cell x is the character x == on */
+        void set_row(std::size_t y, std::string_view cells, char on) noexcept {
+            Word * row = row_words(y);
+            const std::size_t size = std::min(cells.size(), m_width);
+
+            bj::isa::dispatch([&]() {
+                for (std::size_t w = 0 ; w != m_words_per_row ; ++w) {
+                    const std::size_t from = w * Word_Bits;
+                    const std::size_t to   = std::min(from + Word_Bits, size);
+
+                    Word word = 0;
+                    for (std::size_t x = from ; x < to ; ++x) {
+                        word |= Word(cells[x] == on ? 1 : 0) << (x - from);
+                    }
+                    row[w] = word;
+                }
+            });
+        }
+
+        // ==== Rectangles, bounds are included
+
+        void set_rectangle(std::size_t left, std::size_t top, std::size_t right, std::size_t bottom) noexcept {
+            apply_rectangle(left, top, right, bottom, [](Word w, Word m) { return w | m; });
+        }
+
+        void clear_rectangle(std::size_t left, std::size_t top, std::size_t right, std::size_t bottom) noexcept {
+            apply_rectangle(left, top, right, bottom, [](Word w, Word m) { return w & ~m; });
+        }
+
+        void toggle_rectangle(std::size_t left, std::size_t top, std::size_t right, std::size_t bottom) noexcept {
+            apply_rectangle(left, top, right, bottom, [](Word w, Word m) { return w ^ m; });
+        }
+
+        // ==== Rotations of a row or a column, towards the right / the bottom
+
+        void rotate_row(std::size_t y, std::size_t by) {
+            by %= m_width;
+            if (by == 0) return;
+
+            Word * row = row_words(y);
+            const std::vector<Word> state(row, row + m_words_per_row);
+
+            // New cell x is old cell x - by, or x - by + width when it wraps
+            for (std::size_t w = 0 ; w != m_words_per_row ; ++w) {
+                const std::ptrdiff_t from = static_cast<std::ptrdiff_t>(w * Word_Bits) - static_cast<std::ptrdiff_t>(by);
+                row[w] = extract(state.data(), from) | extract(state.data(), from + static_cast<std::ptrdiff_t>(m_width));
+            }
+
+            trim();
+        }
+
+        void rotate_column(std::size_t x, std::size_t by) {
+            by %= m_height;
+            if (by == 0) return;
+
+            std::vector<bool> state(m_height);
+            for (std::size_t y = 0 ; y != m_height ; ++y) state[y] = get(x, y);
+
+            for (std::size_t y = 0 ; y != m_height ; ++y) {
+                set(x, (y + by) % m_height, state[y]);
+            }
+        }
+
+        // ==== Shifts, with 0 filling. Used to count neighbours with bitwise operations.
+
+        /**
+         * Returns the grid moved by (dx, dy): the cell (x, y) of the result
+         * is the cell (x - dx, y - dy) of this grid.
+         */
+        [[nodiscard]] BitGrid shifted(std::ptrdiff_t dx, std::ptrdiff_t dy) const {
+            BitGrid result(m_width, m_height);
+
+            for (std::size_t y = 0 ; y != m_height ; ++y) {
+                const std::ptrdiff_t source_y = static_cast<std::ptrdiff_t>(y) - dy;
+                if (source_y < 0 || source_y >= static_cast<std::ptrdiff_t>(m_height)) continue;
+
+                const Word * source = row_words(static_cast<std::size_t>(source_y));
+                Word * destination = result.row_words(y);
+
+                for (std::size_t w = 0 ; w != m_words_per_row ; ++w) {
+                    destination[w] = extract(source, static_cast<std::ptrdiff_t>(w * Word_Bits) - dx);
+                }
+            }
+
+            result.trim();
+            return result;
+        }
+
+        BitGrid & operator&=(const BitGrid & other) noexcept {
+            apply_words(other, [](Word lhs, Word rhs) { return lhs & rhs; });
+            return *this;
+        }
+
+        BitGrid & operator|=(const BitGrid & other) noexcept {
+            apply_words(other, [](Word lhs, Word rhs) { return lhs | rhs; });
+            return *this;
+        }
+
+        BitGrid & operator^=(const BitGrid & other) noexcept {
+            apply_words(other, [](Word lhs, Word rhs) { return lhs ^ rhs; });
+            return *this;
+        }
+
+        // ==== Whole grid transformations
+
+        void flip_horizontal() {
+            BitGrid result(m_width, m_height);
+            for (std::size_t y = 0 ; y != m_height ; ++y) {
+                for (std::size_t x = 0 ; x != m_width ; ++x) {
+                    if (get(x, y)) result.set(m_width - 1 - x, y);
+                }
+            }
+            *this = std::move(result);
+        }
+
+        void flip_vertical() {
+            for (std::size_t y = 0 ; y < m_height / 2 ; ++y) {
+                std::swap_ranges(row_words(y), row_words(y) + m_words_per_row, row_words(m_height - 1 - y));
+            }
+        }
+
+        /** Rotates the grid by 90° clockwise */
+        void rotate_clockwise() {
+            BitGrid result(m_height, m_width);
+            for (std::size_t y = 0 ; y != m_height ; ++y) {
+                for (std::size_t x = 0 ; x != m_width ; ++x) {
+                    if (get(x, y)) result.set(m_height - 1 - y, x);
+                }
+            }
+            *this = std::move(result);
+        }
+
+        // ==== Output
+
+        /** Number of cells that are on */
+        [[nodiscard]] std::size_t count() const noexcept {
+            return bj::isa::dispatch([&]() {
+                std::size_t total = 0;
+                for (const Word word : m_words) total += static_cast<std::size_t>(std::popcount(word));
+                return total;
+            });
+        }
+
+        friend std::ostream & operator<<(std::ostream & stream, const BitGrid & self) {
+            for (std::size_t y = 0 ; y != self.m_height ; ++y) {
+                for (std::size_t x = 0 ; x != self.m_width ; ++x) {
+                    stream << (self.get(x, y) ? '#' : '.');
+                }
+                stream << '\n';
+            }
+            return stream;
+        }
+    };
+}
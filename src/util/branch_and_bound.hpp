@@ -0,0 +1,133 @@
+#pragma once
+
+#include "thread_pool.hpp"
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Depth first branch and bound, on the shared thread pool.
+//
+// A problem is described by functions on its nodes (partial solutions):
+// - children(node, emit) calls emit(child) for every extension of the node
+// - bound(node) is an optimistic score: no solution in the subtree of the
+//   node can be better
+// - evaluate(node) returns the score of the node if it is a complete
+//   solution, std::nullopt else
+//
+// const auto best = bj::branch_and_bound::minimize<int>(root, children, bound, evaluate);
+//
+// The best known score (the incumbent) is an atomic shared by all the
+// workers, so a solution found by one thread prunes the others at once.
+
+namespace bj::branch_and_bound {
+    /** How the search is run */
+    struct Options {
+        /** Subtrees per thread, the root is split until there are enough */
+        std::size_t subtrees_per_thread = 8;
+    };
+
+    namespace details {
+        template <typename Score, bool Minimize>
+        class Incumbent {
+            static_assert(std::is_arithmetic_v<Score>, "The incumbent is stored in an atomic");
+
+            /** The worst possible score, that stands for "no solution yet" */
+            static constexpr Score Nothing = Minimize
+                ? std::numeric_limits<Score>::max()
+                : std::numeric_limits<Score>::lowest();
+
+            std::atomic<Score> m_score { Nothing };
+
+        public:
+            [[nodiscard]] static bool is_better(Score lhs, Score rhs) noexcept {
+                if constexpr (Minimize) return lhs < rhs;
+                else                    return lhs > rhs;
+            }
+
+            /** True if a subtree whose bound is this may contain a better solution */
+            [[nodiscard]] bool can_improve(Score bound) const noexcept {
+                return is_better(bound, m_score.load(std::memory_order_relaxed));
+            }
+
+            void offer(Score score) noexcept {
+                Score current = m_score.load(std::memory_order_relaxed);
+                while (is_better(score, current)
+                    && !m_score.compare_exchange_weak(current, score, std::memory_order_relaxed)) {
+                }
+            }
+
+            [[nodiscard]] std::optional<Score> get() const noexcept {
+                const Score score = m_score.load(std::memory_order_relaxed);
+                if (score == Nothing) return std::nullopt;
+                return score;
+            }
+        };
+
+        template <typename Score, bool Minimize, typename Node, typename Children, typename Bound, typename Evaluate>
+        [[nodiscard]] std::optional<Score> search(
+            Node root, Children & children, Bound & bound, Evaluate & evaluate, const Options & options
+        ) {
+            Incumbent<Score, Minimize> incumbent;
+
+            const auto visit = [&](const Node & node, auto && on_child) {
+                if (!incumbent.can_improve(bound(node))) return;
+
+                if (const std::optional<Score> score = evaluate(node)) {
+                    incumbent.offer(*score);
+                }
+
+                children(node, on_child);
+            };
+
+            const auto explore = [&](const auto & self, const Node & node) -> void {
+                visit(node, [&](const Node & child) { self(self, child); });
+            };
+
+            ThreadPool & pool = ThreadPool::shared();
+            if (pool.size() == 1) {
+                explore(explore, root);
+                return incumbent.get();
+            }
+
+            // Split the top of the tree breadth first, then explore the
+            // subtrees in parallel
+            const std::size_t wanted = pool.size() * options.subtrees_per_thread;
+            std::vector<Node> subtrees { std::move(root) };
+            std::vector<Node> next;
+
+            while (!subtrees.empty() && subtrees.size() < wanted) {
+                next.clear();
+                for (const Node & node : subtrees) {
+                    visit(node, [&](Node child) { next.push_back(std::move(child)); });
+                }
+                subtrees.swap(next);
+            }
+
+            pool.parallel_for(subtrees.size(), [&](std::size_t i) {
+                explore(explore, subtrees[i]);
+            });
+
+            return incumbent.get();
+        }
+    }
+
+    /** The lowest score of the complete solutions under root */
+    template <typename Score, typename Node, typename Children, typename Bound, typename Evaluate>
+    [[nodiscard]] std::optional<Score> minimize(
+        Node root, Children children, Bound bound, Evaluate evaluate, Options options = {}
+    ) {
+        return details::search<Score, true>(std::move(root), children, bound, evaluate, options);
+    }
+
+    /** The highest score of the complete solutions under root */
+    template <typename Score, typename Node, typename Children, typename Bound, typename Evaluate>
+    [[nodiscard]] std::optional<Score> maximize(
+        Node root, Children children, Bound bound, Evaluate evaluate, Options options = {}
+    ) {
+        return details::search<Score, false>(std::move(root), children, bound, evaluate, options);
+    }
+}
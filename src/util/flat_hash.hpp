@@ -0,0 +1,395 @@
+#pragma once
+
+#include "position.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Open addressing hash set and hash map, for small default constructible
+// keys like positions.
+//
+// The layout is the one of Abseil's "Swiss tables": the slots are in one
+// array, and a parallel array stores one control byte per slot (empty,
+// deleted or 7 bits of the hash of the key). Lookups compare 16 control
+// bytes at once, and only compare the keys whose 7 bits match.
+
+namespace bj {
+    /** Mixes the bits of x (murmur3 finalizer) */
+    [[nodiscard]] constexpr std::uint64_t mix_hash(std::uint64_t x) noexcept {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    /** Hash of integer coordinates */
+    template <typename... Ints>
+    [[nodiscard]] constexpr std::size_t hash_integers(Ints... values) noexcept {
+        std::uint64_t h = 0;
+        ((h = (h ^ static_cast<std::uint32_t>(values)) * 0x9E3779B97F4A7C15ULL), ...);
+        return static_cast<std::size_t>(mix_hash(h));
+    }
+
+    /** Hash used by the flat containers. Defaults to std::hash */
+    template <typename T>
+    struct Hash : std::hash<T> {};
+
+    /** std::hash is the identity on integers, but the table needs mixed bits */
+    template <typename Int>
+    requires (std::is_integral_v<Int>)
+    struct Hash<Int> {
+        [[nodiscard]] constexpr std::size_t operator()(Int value) const noexcept {
+            return static_cast<std::size_t>(mix_hash(static_cast<std::uint64_t>(value)));
+        }
+    };
+
+    template <typename Int, std::size_t N>
+    struct Hash<std::array<Int, N>> {
+        [[nodiscard]] constexpr std::size_t operator()(const std::array<Int, N> & coordinates) const noexcept {
+            return [&]<std::size_t... I>(std::index_sequence<I...>) {
+                return hash_integers(coordinates[I]...);
+            }(std::make_index_sequence<N>());
+        }
+    };
+
+    template <>
+    struct Hash<bj::Position> {
+        [[nodiscard]] constexpr std::size_t operator()(const bj::Position & position) const noexcept {
+            return hash_integers(position.x, position.y);
+        }
+    };
+
+    namespace flat_hash {
+        using Control = std::int8_t;
+        static constexpr Control Empty   = -128;
+        static constexpr Control Deleted = -2;
+        static constexpr std::size_t Group_Size = 16;
+
+        /** Bitmask of the control bytes of the group that are equal to value */
+        [[nodiscard]] inline std::uint32_t match(const Control * group, Control value) noexcept {
+#if defined(__SSE2__)
+            const __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(value))));
+#else
+            std::uint32_t mask = 0;
+            for (std::size_t i = 0 ; i != Group_Size ; ++i) {
+                if (group[i] == value) mask |= std::uint32_t(1) << i;
+            }
+            return mask;
+#endif
+        }
+
+        /** Bitmask of the control bytes of the group that are empty or deleted */
+        [[nodiscard]] inline std::uint32_t match_free(const Control * group) noexcept {
+#if defined(__SSE2__)
+            // Empty and Deleted are the only negative values
+            const __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(ctrl));
+#else
+            std::uint32_t mask = 0;
+            for (std::size_t i = 0 ; i != Group_Size ; ++i) {
+                if (group[i] < 0) mask |= std::uint32_t(1) << i;
+            }
+            return mask;
+#endif
+        }
+
+        /**
+         * The table shared by FlatHashSet and FlatHashMap.
+         * KeyOf extracts the key from a slot.
+         */
+        template <typename Key, typename Slot, typename KeyOf, typename Hasher, typename Allocator>
+        class Table {
+        private:
+            using ControlAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Control>;
+            using SlotAllocator    = typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>;
+
+            // The first Group_Size control bytes are duplicated at the end
+            // so a group can always be loaded in one read.
+            std::vector<Control, ControlAllocator> m_control;
+            std::vector<Slot, SlotAllocator>       m_slots;
+            std::size_t m_size    = 0;
+            std::size_t m_deleted = 0;
+            [[no_unique_address]] Hasher m_hasher;
+
+        public:
+            template <bool Const>
+            class Iterator {
+                friend class Table;
+                friend class Iterator<!Const>;
+                using TablePtr = std::conditional_t<Const, const Table *, Table *>;
+
+                TablePtr m_table;
+                std::size_t m_index;
+
+                Iterator(TablePtr table, std::size_t index) : m_table(table), m_index(index) { skip_free(); }
+
+                void skip_free() {
+                    while (m_index < m_table->m_slots.size() && m_table->m_control[m_index] < 0) ++m_index;
+                }
+
+            public:
+                using value_type        = Slot;
+                using difference_type   = std::ptrdiff_t;
+                using reference         = std::conditional_t<Const, const Slot &, Slot &>;
+                using pointer           = std::conditional_t<Const, const Slot *, Slot *>;
+                using iterator_category = std::forward_iterator_tag;
+
+                Iterator() : m_table(nullptr), m_index(0) {}
+                operator Iterator<true>() const { return Iterator<true>(m_table, m_index); }
+
+                reference operator*()  const { return m_table->m_slots[m_index]; }
+                pointer   operator->() const { return &m_table->m_slots[m_index]; }
+                Iterator & operator++() { ++m_index; skip_free(); return *this; }
+                Iterator operator++(int) { Iterator copy = *this; ++*this; return copy; }
+                bool operator==(const Iterator & other) const { return m_index == other.m_index; }
+            };
+
+            using iterator       = Iterator<false>;
+            using const_iterator = Iterator<true>;
+
+            explicit Table(const Allocator & allocator = Allocator())
+            : m_control(ControlAllocator(allocator)), m_slots(SlotAllocator(allocator)) {}
+
+            [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+            [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+
+            iterator begin() { return iterator(this, 0); }
+            iterator end()   { return iterator(this, m_slots.size()); }
+            const_iterator begin() const { return const_iterator(this, 0); }
+            const_iterator end()   const { return const_iterator(this, m_slots.size()); }
+
+            void clear() {
+                std::fill(m_control.begin(), m_control.end(), Empty);
+                m_size = 0;
+                m_deleted = 0;
+            }
+
+            /** Ensures that count elements can be inserted without rehashing */
+            void reserve(std::size_t count) {
+                std::size_t capacity = Group_Size;
+                while (capacity * 7 / 8 < count) capacity *= 2;
+                if (capacity > m_slots.size()) rehash(capacity);
+            }
+
+            [[nodiscard]] iterator find(const Key & key) {
+                return iterator(this, find_index(key));
+            }
+
+            [[nodiscard]] const_iterator find(const Key & key) const {
+                return const_iterator(this, find_index(key));
+            }
+
+            [[nodiscard]] bool contains(const Key & key) const {
+                return find_index(key) != m_slots.size();
+            }
+
+            [[nodiscard]] std::size_t count(const Key & key) const {
+                return contains(key) ? 1 : 0;
+            }
+
+            std::size_t erase(const Key & key) {
+                const std::size_t index = find_index(key);
+                if (index == m_slots.size()) return 0;
+                set_control(index, Deleted);
+                --m_size;
+                ++m_deleted;
+                return 1;
+            }
+
+        protected:
+            /**
+             * Returns the index of the slot of key, and true if the slot was
+             * just reserved (its content must then be written by the caller)
+             */
+            std::pair<std::size_t, bool> find_or_prepare_insert(const Key & key) {
+                const std::size_t hash = m_hasher(key);
+
+                if (!m_slots.empty()) {
+                    const std::size_t found = find_index(key, hash);
+                    if (found != m_slots.size()) return { found, false };
+                }
+
+                if ((m_size + m_deleted + 1) * 8 > m_slots.size() * 7) {
+                    // Only grow if the table is really full, else just remove the tombstones
+                    rehash(m_slots.empty() ? Group_Size : (m_size + 1) * 8 > m_slots.size() * 7 / 2 ? m_slots.size() * 2 : m_slots.size());
+                }
+
+                const std::size_t index = find_free(hash);
+                if (m_control[index] == Deleted) --m_deleted;
+                set_control(index, h2(hash));
+                ++m_size;
+                return { index, true };
+            }
+
+            [[nodiscard]] Slot & slot_at(std::size_t index) { return m_slots[index]; }
+
+        private:
+            [[nodiscard]] static std::size_t h1(std::size_t hash) noexcept { return hash >> 7; }
+            [[nodiscard]] static Control     h2(std::size_t hash) noexcept { return static_cast<Control>(hash & 0x7F); }
+
+            void set_control(std::size_t index, Control value) {
+                m_control[index] = value;
+                if (index < Group_Size) m_control[m_slots.size() + index] = value;
+            }
+
+            [[nodiscard]] std::size_t find_index(const Key & key) const {
+                if (m_slots.empty()) return 0;
+                return find_index(key, m_hasher(key));
+            }
+
+            /** Quadratic probing on groups. Returns m_slots.size() if not found. */
+            [[nodiscard]] std::size_t find_index(const Key & key, std::size_t hash) const {
+                const std::size_t mask = m_slots.size() - 1;
+                const Control tag = h2(hash);
+                std::size_t position = h1(hash) & mask;
+
+                for (std::size_t step = Group_Size ; ; step += Group_Size) {
+                    const Control * group = m_control.data() + position;
+
+                    for (std::uint32_t candidates = match(group, tag) ; candidates != 0 ; candidates &= candidates - 1) {
+                        const std::size_t index = (position + static_cast<std::size_t>(__builtin_ctz(candidates))) & mask;
+                        if (KeyOf()(m_slots[index]) == key) return index;
+                    }
+
+                    if (match(group, Empty) != 0) return m_slots.size();
+
+                    position = (position + step) & mask;
+                }
+            }
+
+            [[nodiscard]] std::size_t find_free(std::size_t hash) const {
+                const std::size_t mask = m_slots.size() - 1;
+                std::size_t position = h1(hash) & mask;
+
+                for (std::size_t step = Group_Size ; ; step += Group_Size) {
+                    if (const std::uint32_t free = match_free(m_control.data() + position); free != 0) {
+                        return (position + static_cast<std::size_t>(__builtin_ctz(free))) & mask;
+                    }
+
+                    position = (position + step) & mask;
+                }
+            }
+
+            void rehash(std::size_t new_capacity) {
+                auto old_control = std::move(m_control);
+                auto old_slots   = std::move(m_slots);
+
+                m_control = std::vector<Control, ControlAllocator>(new_capacity + Group_Size, Empty, old_control.get_allocator());
+                m_slots   = std::vector<Slot, SlotAllocator>(new_capacity, old_slots.get_allocator());
+                m_deleted = 0;
+
+                for (std::size_t i = 0 ; i != old_slots.size() ; ++i) {
+                    if (old_control[i] < 0) continue;
+
+                    const std::size_t hash = m_hasher(KeyOf()(old_slots[i]));
+                    const std::size_t index = find_free(hash);
+                    set_control(index, h2(hash));
+                    m_slots[index] = std::move(old_slots[i]);
+                }
+            }
+        };
+
+        struct Identity {
+            template <typename T>
+            [[nodiscard]] const T & operator()(const T & value) const noexcept { return value; }
+        };
+
+        struct First {
+            template <typename Pair>
+            [[nodiscard]] const auto & operator()(const Pair & pair) const noexcept { return pair.first; }
+        };
+    }
+
+    /** A drop-in replacement for std::set / std::unordered_set of small keys */
+    template <typename Key, typename Hasher = bj::Hash<Key>, typename Allocator = std::allocator<Key>>
+    class FlatHashSet : public flat_hash::Table<Key, Key, flat_hash::Identity, Hasher, Allocator> {
+        using Base = flat_hash::Table<Key, Key, flat_hash::Identity, Hasher, Allocator>;
+
+    public:
+        using Base::Base;
+        using value_type = Key;
+
+        std::pair<typename Base::iterator, bool> insert(const Key & key) {
+            const auto [index, inserted] = this->find_or_prepare_insert(key);
+            if (inserted) this->slot_at(index) = key;
+            return { typename Base::iterator(this->find(key)), inserted };
+        }
+
+        template <typename InputIt>
+        void insert(InputIt first, InputIt last) {
+            for (; first != last ; ++first) insert(*first);
+        }
+
+        [[nodiscard]] bool operator==(const FlatHashSet & other) const {
+            if (this->size() != other.size()) return false;
+            for (const Key & key : *this) {
+                if (!other.contains(key)) return false;
+            }
+            return true;
+        }
+    };
+
+    /**
+     * A drop-in replacement for std::map / std::unordered_map of small keys
+     * and values. Elements are std::pair<Key, Value>: the key must not be
+     * modified through iterators.
+     */
+    template <typename Key, typename Value, typename Hasher = bj::Hash<Key>, typename Allocator = std::allocator<std::pair<Key, Value>>>
+    class FlatHashMap : public flat_hash::Table<Key, std::pair<Key, Value>, flat_hash::First, Hasher, Allocator> {
+        using Base = flat_hash::Table<Key, std::pair<Key, Value>, flat_hash::First, Hasher, Allocator>;
+
+    public:
+        using Base::Base;
+        using key_type    = Key;
+        using mapped_type = Value;
+        using value_type  = std::pair<Key, Value>;
+
+        Value & operator[](const Key & key) {
+            const auto [index, inserted] = this->find_or_prepare_insert(key);
+            auto & slot = this->slot_at(index);
+            if (inserted) slot = value_type(key, Value());
+            return slot.second;
+        }
+
+        template <typename... Args>
+        std::pair<typename Base::iterator, bool> try_emplace(const Key & key, Args &&... args) {
+            const auto [index, inserted] = this->find_or_prepare_insert(key);
+            if (inserted) this->slot_at(index) = value_type(key, Value(std::forward<Args>(args)...));
+            return { this->find(key), inserted };
+        }
+
+        template <typename V>
+        std::pair<typename Base::iterator, bool> insert_or_assign(const Key & key, V && value) {
+            const auto [index, inserted] = this->find_or_prepare_insert(key);
+            this->slot_at(index) = value_type(key, std::forward<V>(value));
+            return { this->find(key), inserted };
+        }
+
+        /** Like std::map::at, throws std::out_of_range if the key is missing */
+        [[nodiscard]] Value & at(const Key & key) {
+            const auto it = this->find(key);
+            if (it == this->end()) throw std::out_of_range("bj::FlatHashMap::at: missing key");
+            return it->second;
+        }
+
+        [[nodiscard]] const Value & at(const Key & key) const {
+            const auto it = this->find(key);
+            if (it == this->end()) throw std::out_of_range("bj::FlatHashMap::at: missing key");
+            return it->second;
+        }
+    };
+}
@@ -1,9 +1,23 @@
 
 #pragma once
 
+#include "flat_hash.hpp"
+#include "hashlife.hpp"
 #include "position.hpp"
+#include "stencil.hpp"
+#include "tiled_stepper.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
 #include <set>
-#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 namespace bj {
     inline void print_game_of_life(const std::set<bj::Position> & position, int xMin, int xMax, int yMin, int yMax) {
@@ -19,39 +33,276 @@ namespace bj {
         }
     }
 
-    template <typename Rules>
-    void game_of_life(std::set<typename Rules::Element> & positions, Rules rules) {
-        using Element = Rules::Element;
-        std::set<Element> old = std::move(positions);
+    namespace game_of_life_engine {
+        /**
+         * Rules on bj::Position that know the rectangle out of which no cell
+         * is ever valid. Their neighbourhood must be the same around every
+         * cell (get_neighbours is only called on the origin), and be a
+         * std::array so the loops on the neighbours are unrolled.
+         */
+        template <typename Rules>
+        concept Bounded = std::same_as<typename Rules::Element, bj::Position>
+            && requires(const Rules & rules) {
+                { rules.bounds() } -> std::convertible_to<bj::Rectangle>;
+                std::tuple_size<decltype(rules.get_neighbours(bj::Position {}))>::value;
+            };
 
-        std::map<Element, size_t> counts;
+        /**
+         * Unbounded rules on bj::Position that declare
+         * `static constexpr bool Is_Outer_Totalistic = true;`: is_on only
+         * depends on was_on and the count, every cell is valid, and the
+         * neighbourhood is the same around every cell and included in the
+         * 3x3 square around it.
+         */
+        template <typename Rules>
+        concept OuterTotalistic = std::same_as<typename Rules::Element, bj::Position>
+            && !Bounded<Rules>
+            && requires { requires Rules::Is_Outer_Totalistic; };
 
-        for (const auto & position : old) {
-            counts[position];   // Ensure that currently living cells are in the map
+        /**
+         * Living cells in a flat hash set, neighbour counts in a flat hash map.
+         * Works for any element and any neighbourhood.
+         */
+        template <typename Rules>
+        class Sparse {
+            using Element = typename Rules::Element;
 
-            for (const auto & neighbour : rules.get_neighbours(position)) {
-                ++counts[neighbour];
+            Rules m_rules;
+            bj::FlatHashSet<Element> m_alive;
+
+        public:
+            Sparse(const std::set<Element> & positions, Rules rules) : m_rules(std::move(rules)) {
+                m_alive.reserve(positions.size());
+                m_alive.insert(positions.begin(), positions.end());
             }
-        }
 
-        for (const auto & [position, count] : counts) {
-            if (!rules.is_valid(position)) continue;
+            void step() {
+                bj::FlatHashMap<Element, size_t> counts;
+                counts.reserve(m_alive.size() * 3);
+
+                for (const auto & position : m_alive) {
+                    counts[position];   // Ensure that currently living cells are in the map
+
+                    for (const auto & neighbour : m_rules.get_neighbours(position)) {
+                        ++counts[neighbour];
+                    }
+                }
+
+                bj::FlatHashSet<Element> next;
+                next.reserve(m_alive.size());
 
-            if (rules.is_on(position, old.contains(position), count)) {
-                positions.insert(position);
+                for (const auto & [position, count] : counts) {
+                    if (!m_rules.is_valid(position)) continue;
+
+                    if (m_rules.is_on(position, m_alive.contains(position), count)) {
+                        next.insert(position);
+                    }
+                }
+
+                m_alive = std::move(next);
             }
-        }
+
+            [[nodiscard]] std::set<Element> to_set() const {
+                return std::set<Element>(m_alive.begin(), m_alive.end());
+            }
+        };
+
+        /**
+         * Every cell of the bounds in a byte array with a dead border, and a
+         * second array for the next generation. The neighbours are read with
+         * precomputed index offsets, and the generations are computed by tiles
+         * with bj::TiledStepper.
+         *
+         * Cells given out of the bounds are ignored.
+         */
+        template <Bounded Rules>
+        class Dense {
+            Rules m_rules;
+            bj::Rectangle m_bounds;
+            std::ptrdiff_t m_margin = 0;
+            std::ptrdiff_t m_stride;
+            using Neighbours = decltype(std::declval<const Rules &>().get_neighbours(bj::Position {}));
+            static constexpr std::size_t Nb_Neighbours = std::tuple_size_v<Neighbours>;
+            using Offsets = std::array<std::ptrdiff_t, Nb_Neighbours>;
+            Offsets m_neighbour_offsets;
+            std::vector<std::uint8_t> m_valid;
+            std::vector<std::uint8_t> m_current;
+            std::vector<std::uint8_t> m_next;
+            bj::TiledStepper m_stepper;
+
+            [[nodiscard]] std::ptrdiff_t index_of(int x, int y) const noexcept {
+                return (y - m_bounds.top + m_margin) * m_stride + (x - m_bounds.left + m_margin);
+            }
+
+        public:
+            Dense(const std::set<bj::Position> & positions, Rules rules)
+            : m_rules(std::move(rules)), m_bounds(m_rules.bounds()), m_stepper(0, 0, true) {
+                const auto neighbours = m_rules.get_neighbours(bj::Position { 0, 0 });
+                for (const bj::Position & neighbour : neighbours) {
+                    m_margin = std::max<std::ptrdiff_t>(m_margin, std::max(std::abs(neighbour.x), std::abs(neighbour.y)));
+                }
+
+                m_stride = (m_bounds.right - m_bounds.left + 1) + 2 * m_margin;
+                const std::ptrdiff_t rows = (m_bounds.bottom - m_bounds.top + 1) + 2 * m_margin;
+
+                std::array<bj::stencil::Offset<2>, Nb_Neighbours> stencil;
+                for (std::size_t i = 0 ; i != Nb_Neighbours ; ++i) stencil[i] = { neighbours[i].x, neighbours[i].y };
+                m_neighbour_offsets = bj::stencil::to_linear(stencil, { 1, m_stride });
+
+                // Tiles are larger than the neighbourhood, so only the
+                // adjacent tiles are read
+                m_stepper = bj::TiledStepper(
+                    static_cast<size_t>(m_bounds.right - m_bounds.left + 1),
+                    static_cast<size_t>(m_bounds.bottom - m_bounds.top + 1),
+                    true,
+                    std::max<size_t>(bj::TiledStepper::Default_Tile_Size, static_cast<size_t>(m_margin))
+                );
+
+                m_valid  .resize(static_cast<size_t>(m_stride * rows), 0);
+                m_current.resize(static_cast<size_t>(m_stride * rows), 0);
+                m_next   .resize(static_cast<size_t>(m_stride * rows), 0);
+
+                m_bounds.for_each_position([&](bj::Position position) {
+                    m_valid[index_of(position.x, position.y)] = m_rules.is_valid(position);
+                });
+
+                for (const bj::Position & position : positions) {
+                    if (position.x < m_bounds.left || position.x > m_bounds.right)  continue;
+                    if (position.y < m_bounds.top  || position.y > m_bounds.bottom) continue;
+                    m_current[index_of(position.x, position.y)] = 1;
+                }
+            }
+
+            void step() {
+                // Local copies: the compiler can not know that writing in
+                // the next buffer does not modify the vectors themselves
+                const std::uint8_t * const valid   = m_valid.data();
+                const std::uint8_t * const current = m_current.data();
+                std::uint8_t * const       next    = m_next.data();
+                const Offsets offsets = m_neighbour_offsets;
+
+                m_stepper.step([&](const bj::TiledStepper::Tile & tile) {
+                    bool changed = false;
+
+                    const int left  = m_bounds.left + static_cast<int>(tile.left);
+                    const int right = m_bounds.left + static_cast<int>(tile.right);
+
+                    for (int y = m_bounds.top + static_cast<int>(tile.top) ; y != m_bounds.top + static_cast<int>(tile.bottom) ; ++y) {
+                        const std::ptrdiff_t row_begin = index_of(left, y);
+                        std::ptrdiff_t index = row_begin;
+
+                        for (int x = left ; x != right ; ++x, ++index) {
+                            if (!valid[index]) {
+                                next[index] = 0;
+                                continue;
+                            }
+
+                            size_t count = 0;
+                            for (const std::ptrdiff_t offset : offsets) {
+                                count += current[index + offset];
+                            }
+
+                            // Like the sparse engine, that never visits them,
+                            // dead cells without any neighbour stay dead
+                            if (count == 0 && current[index] == 0) {
+                                next[index] = 0;
+                                continue;
+                            }
+
+                            next[index] = m_rules.is_on(bj::Position { x, y }, current[index] != 0, count);
+                        }
+
+                        changed = changed || std::memcmp(current + row_begin, next + row_begin, static_cast<size_t>(right - left)) != 0;
+                    }
+
+                    return changed;
+                });
+
+                m_current.swap(m_next);
+            }
+
+            [[nodiscard]] std::set<bj::Position> to_set() const {
+                std::set<bj::Position> retval;
+
+                m_bounds.for_each_position([&](bj::Position position) {
+                    if (m_current[index_of(position.x, position.y)]) retval.insert(position);
+                });
+
+                return retval;
+            }
+        };
+
+        /** HashLife: advances by powers of two with memoized quadtrees */
+        template <OuterTotalistic Rules>
+        class Memoized {
+            bj::HashLife m_universe;
+
+            [[nodiscard]] static bj::HashLife::Rule to_rule(const Rules & rules) {
+                const bj::Position origin { 0, 0 };
+
+                bj::HashLife::Rule rule;
+                for (const bj::Position & neighbour : rules.get_neighbours(origin)) {
+                    assert(std::abs(neighbour.x) <= 1 && std::abs(neighbour.y) <= 1);
+                    rule.neighbours.push_back(neighbour);
+                }
+
+                for (size_t count = 0 ; count <= rule.neighbours.size() ; ++count) {
+                    // Like the other engines, cells without any neighbour are never born
+                    rule.birth[count]   = count != 0 && rules.is_on(origin, false, count);
+                    rule.survive[count] = rules.is_on(origin, true, count);
+                }
+
+                return rule;
+            }
+
+        public:
+            Memoized(const std::set<bj::Position> & positions, const Rules & rules)
+            : m_universe(positions, to_rule(rules)) {}
+
+            void advance(size_t loops) { m_universe.advance(loops); }
+
+            [[nodiscard]] std::set<bj::Position> to_set() const { return m_universe.to_set(); }
+        };
+    }
+
+    template <typename Rules>
+    void game_of_life(std::set<typename Rules::Element> & positions, Rules rules) {
+        game_of_life_engine::Sparse<Rules> engine(positions, std::move(rules));
+        engine.step();
+        positions = engine.to_set();
     }
 
+    /**
+     * Runs loops generations of the game of life, from the given living cells.
+     *
+     * Rules that provide bounds() (see game_of_life_engine::Bounded) are run
+     * on a dense grid, outer totalistic ones with HashLife, other ones on
+     * hash sets.
+     *
+     * Every engine considers that a dead cell without any living neighbour
+     * stays dead: is_on is not called for it.
+     */
     template <typename Rules>
     [[nodiscard]] auto game_of_life(size_t loops, std::set<typename Rules::Element> positions, Rules rules) {
-        for (size_t i = 0 ; i != loops; ++i) {
-            game_of_life(positions, rules);
+        const auto run = [loops](auto engine) {
+            for (size_t i = 0 ; i != loops; ++i) {
+                engine.step();
+            }
+
+            return engine.to_set();
+        };
+
+        if constexpr (game_of_life_engine::Bounded<Rules>) {
+            return run(game_of_life_engine::Dense<Rules>(positions, std::move(rules)));
+        } else if constexpr (game_of_life_engine::OuterTotalistic<Rules>) {
+            game_of_life_engine::Memoized<Rules> engine(positions, rules);
+            engine.advance(loops);
+            return engine.to_set();
+        } else {
+            return run(game_of_life_engine::Sparse<Rules>(positions, std::move(rules)));
         }
-        
-        return positions;
     }
-    
+
 /*
     // Example of Rules implementation:
 
@@ -75,6 +326,11 @@ namespace bj {
                 return c == 3;
             }
         }
+
+        // Optional: enables the dense engine
+        [[nodiscard]] bj::Rectangle bounds() const noexcept {
+            return bj::Rectangle(0, 0, grid_size - 1, grid_size - 1);
+        }
     };
 
 
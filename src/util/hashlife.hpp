@@ -0,0 +1,280 @@
+#pragma once
+
+#include "flat_hash.hpp"
+#include "position.hpp"
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <set>
+#include <vector>
+
+namespace bj {
+    /**
+     * Gosper's HashLife: the universe is a quadtree of canonical (hash-consed)
+     * nodes, and the future of the centre of every node is memoized, so
+     * repetitive patterns are advanced by 2^j generations in a time that
+     * grows with j and not with 2^j.
+     *
+     * Supports the 2-state outer-totalistic rules on an unbounded plane whose
+     * neighbourhood is included in the 3x3 square around the cell:
+     * - Moore neighbourhood (8 neighbours, like Conway's game of life)
+     * - Hexagonal grids in axial coordinates: the 6 neighbours of (x, y) are
+     *   (x ± 1, y), (x, y ± 1), (x + 1, y - 1) and (x - 1, y + 1).
+     */
+    class HashLife {
+    public:
+        /** Rule of the automaton: neighbour offsets, and next state by neighbour count */
+        struct Rule {
+            std::vector<bj::Position> neighbours;
+            std::array<bool, 9> birth   {};     // Dead cell with n neighbours becomes alive
+            std::array<bool, 9> survive {};     // Living cell with n neighbours stays alive
+        };
+
+    private:
+        struct Node {
+            int level;                  // The node is a square of 2^level cells
+            std::uint64_t population;
+            Node * nw = nullptr;
+            Node * ne = nullptr;
+            Node * sw = nullptr;
+            Node * se = nullptr;
+            Node * next = nullptr;      // Centre after 2^(level - 2) generations
+        };
+
+        struct Children {
+            Node * nw; Node * ne; Node * sw; Node * se;
+            [[nodiscard]] bool operator==(const Children &) const = default;
+        };
+
+        struct ChildrenHash {
+            [[nodiscard]] std::size_t operator()(const Children & c) const noexcept {
+                return bj::hash_integers(
+                    reinterpret_cast<std::uintptr_t>(c.nw), reinterpret_cast<std::uintptr_t>(c.ne),
+                    reinterpret_cast<std::uintptr_t>(c.sw), reinterpret_cast<std::uintptr_t>(c.se)
+                );
+            }
+        };
+
+        /** Memoization of the centre after 2^j generations, for j < level - 2 */
+        struct StepKey {
+            Node * node;
+            int j;
+            [[nodiscard]] bool operator==(const StepKey &) const = default;
+        };
+
+        struct StepKeyHash {
+            [[nodiscard]] std::size_t operator()(const StepKey & key) const noexcept {
+                return bj::hash_integers(reinterpret_cast<std::uintptr_t>(key.node), key.j);
+            }
+        };
+
+        Rule m_rule;
+        std::deque<Node> m_nodes;
+        bj::FlatHashMap<Children, Node *, ChildrenHash> m_canonical;
+        bj::FlatHashMap<StepKey, Node *, StepKeyHash> m_slow_steps;
+        std::vector<Node *> m_empty;    // Empty node by level
+        Node * m_dead;
+        Node * m_alive;
+        Node * m_root;
+
+        // ==== Node construction
+
+        [[nodiscard]] Node * join(Node * nw, Node * ne, Node * sw, Node * se) {
+            const Children children { nw, ne, sw, se };
+            if (const auto it = m_canonical.find(children); it != m_canonical.end()) {
+                return it->second;
+            }
+
+            Node & node = m_nodes.emplace_back(Node {
+                nw->level + 1,
+                nw->population + ne->population + sw->population + se->population,
+                nw, ne, sw, se
+            });
+
+            m_canonical.try_emplace(children, &node);
+            return &node;
+        }
+
+        [[nodiscard]] Node * empty(int level) {
+            while (static_cast<int>(m_empty.size()) <= level) {
+                Node * smaller = m_empty.back();
+                m_empty.push_back(join(smaller, smaller, smaller, smaller));
+            }
+
+            return m_empty[level];
+        }
+
+        /** The same pattern, in a node twice as large */
+        [[nodiscard]] Node * expand(Node * node) {
+            Node * e = empty(node->level - 1);
+            return join(
+                join(e, e, e, node->nw), join(e, e, node->ne, e),
+                join(e, node->sw, e, e), join(node->se, e, e, e)
+            );
+        }
+
+        [[nodiscard]] Node * centre(Node * node) {
+            return join(node->nw->se, node->ne->sw, node->sw->ne, node->se->nw);
+        }
+
+        /** True if all the cells are in the central quarter (of side 2^(level - 2)) */
+        [[nodiscard]] bool is_padded(Node * node) {
+            return node->level >= 3 && centre(centre(node))->population == node->population;
+        }
+
+        /** Sets the cell (x, y) of the node, relative to its top left corner */
+        [[nodiscard]] Node * with_cell(Node * node, std::int64_t x, std::int64_t y) {
+            if (node->level == 0) return m_alive;
+
+            const std::int64_t half = std::int64_t(1) << (node->level - 1);
+            if (y < half) {
+                if (x < half) return join(with_cell(node->nw, x, y), node->ne, node->sw, node->se);
+                else          return join(node->nw, with_cell(node->ne, x - half, y), node->sw, node->se);
+            } else {
+                if (x < half) return join(node->nw, node->ne, with_cell(node->sw, x, y - half), node->se);
+                else          return join(node->nw, node->ne, node->sw, with_cell(node->se, x - half, y - half));
+            }
+        }
+
+        // ==== Evolution
+
+        /** Centre 2x2 of a 4x4 node after one generation */
+        [[nodiscard]] Node * base_step(Node * node) {
+            std::array<std::array<bool, 4>, 4> cells;   // [y][x]
+            const auto fill = [&](Node * quarter, int x, int y) {
+                cells[y    ][x    ] = quarter->nw == m_alive;
+                cells[y    ][x + 1] = quarter->ne == m_alive;
+                cells[y + 1][x    ] = quarter->sw == m_alive;
+                cells[y + 1][x + 1] = quarter->se == m_alive;
+            };
+            fill(node->nw, 0, 0); fill(node->ne, 2, 0);
+            fill(node->sw, 0, 2); fill(node->se, 2, 2);
+
+            const auto next_state = [&](int x, int y) {
+                size_t count = 0;
+                for (const bj::Position & offset : m_rule.neighbours) {
+                    count += cells[y + offset.y][x + offset.x];
+                }
+
+                const bool is_on = cells[y][x] ? m_rule.survive[count] : m_rule.birth[count];
+                return is_on ? m_alive : m_dead;
+            };
+
+            return join(next_state(1, 1), next_state(2, 1), next_state(1, 2), next_state(2, 2));
+        }
+
+        /** Centre (level - 1) of the node after 2^j generations, j <= level - 2 */
+        [[nodiscard]] Node * step(Node * node, int j) {
+            if (node->population == 0) return empty(node->level - 1);
+
+            const bool full_speed = j == node->level - 2;
+            if (full_speed && node->next) return node->next;
+            if (!full_speed) {
+                if (const auto it = m_slow_steps.find(StepKey { node, j }); it != m_slow_steps.end()) {
+                    return it->second;
+                }
+            }
+
+            Node * result;
+
+            if (node->level == 2) {
+                result = base_step(node);
+            } else {
+                Node * const nw = node->nw; Node * const ne = node->ne;
+                Node * const sw = node->sw; Node * const se = node->se;
+
+                // The 9 overlapping sub squares of side 2^(level - 1)
+                const int sub_j = full_speed ? node->level - 3 : j;
+                Node * const c00 = step(nw, sub_j);
+                Node * const c01 = step(join(nw->ne, ne->nw, nw->se, ne->sw), sub_j);
+                Node * const c02 = step(ne, sub_j);
+                Node * const c10 = step(join(nw->sw, nw->se, sw->nw, sw->ne), sub_j);
+                Node * const c11 = step(centre(node), sub_j);
+                Node * const c12 = step(join(ne->sw, ne->se, se->nw, se->ne), sub_j);
+                Node * const c20 = step(sw, sub_j);
+                Node * const c21 = step(join(sw->ne, se->nw, sw->se, se->sw), sub_j);
+                Node * const c22 = step(se, sub_j);
+
+                if (full_speed) {
+                    result = join(
+                        step(join(c00, c01, c10, c11), sub_j), step(join(c01, c02, c11, c12), sub_j),
+                        step(join(c10, c11, c20, c21), sub_j), step(join(c11, c12, c21, c22), sub_j)
+                    );
+                } else {
+                    result = join(
+                        centre(join(c00, c01, c10, c11)), centre(join(c01, c02, c11, c12)),
+                        centre(join(c10, c11, c20, c21)), centre(join(c11, c12, c21, c22))
+                    );
+                }
+            }
+
+            if (full_speed) node->next = result;
+            else            m_slow_steps.try_emplace(StepKey { node, j }, result);
+
+            return result;
+        }
+
+        /** Advances the whole universe by 2^j generations */
+        void advance_power_of_two(int j) {
+            while (m_root->level < j + 2 || !is_padded(m_root)) {
+                m_root = expand(m_root);
+            }
+
+            // One more level so the pattern can not leave the result
+            m_root = step(expand(m_root), j);
+        }
+
+        void collect(Node * node, std::int64_t x, std::int64_t y, std::set<bj::Position> & output) const {
+            if (node->population == 0) return;
+
+            if (node->level == 0) {
+                output.insert(bj::Position { static_cast<int>(x), static_cast<int>(y) });
+                return;
+            }
+
+            const std::int64_t half = std::int64_t(1) << (node->level - 1);
+            collect(node->nw, x       , y       , output);
+            collect(node->ne, x + half, y       , output);
+            collect(node->sw, x       , y + half, output);
+            collect(node->se, x + half, y + half, output);
+        }
+
+    public:
+        HashLife(const std::set<bj::Position> & positions, Rule rule) : m_rule(std::move(rule)) {
+            m_dead  = &m_nodes.emplace_back(Node { 0, 0 });
+            m_alive = &m_nodes.emplace_back(Node { 0, 1 });
+            m_empty.push_back(m_dead);
+
+            // The root is centred on (0, 0): it covers [-2^(level - 1), 2^(level - 1)[
+            std::int64_t extent = 1;
+            for (const bj::Position & position : positions) {
+                extent = std::max<std::int64_t>({ extent, std::abs(position.x) + 1, std::abs(position.y) + 1 });
+            }
+
+            int level = 3;
+            while ((std::int64_t(1) << (level - 1)) < extent) ++level;
+
+            m_root = empty(level);
+            const std::int64_t half = std::int64_t(1) << (level - 1);
+            for (const bj::Position & position : positions) {
+                m_root = with_cell(m_root, position.x + half, position.y + half);
+            }
+        }
+
+        /** Advances the universe by the given number of generations */
+        void advance(std::uint64_t generations) {
+            for (int j = 63 ; j >= 0 ; --j) {
+                if (generations & (std::uint64_t(1) << j)) advance_power_of_two(j);
+            }
+        }
+
+        [[nodiscard]] std::uint64_t population() const noexcept { return m_root->population; }
+
+        [[nodiscard]] std::set<bj::Position> to_set() const {
+            std::set<bj::Position> retval;
+            const std::int64_t half = std::int64_t(1) << (m_root->level - 1);
+            collect(m_root, -half, -half, retval);
+            return retval;
+        }
+    };
+}
@@ -1,5 +1,17 @@
-#include <regex>
+#pragma once
+
+#include "static_regex.hpp"
+#include "string_split.hpp"
+#include <cstddef>
+#include <iostream>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace bj {
     /**
@@ -10,55 +22,116 @@ namespace bj {
      * by lines, and only having to use the `add_handler` function to write
      * the correct regex and the associated constructor.
      *
+     * Regexes are compiled at compile time (see static_regex.hpp) and indexed
+     * by the first word of their leading literal, so a line is only matched
+     * against the handlers that start with the same keyword. Handlers are
+     * still tried in the order they were added. The captured groups are
+     * directly converted to the types of the handler parameters.
+     *
      * Example of usage can be found on day 2016-08
      */
     template<typename T>
     class InstructionReader {
-    public:
-        /** Type of functions that can convert a regex decoded string into a T */
-        using Handler = T(const std::vector<std::string> &);
-
     private:
-        /** Individual handler, with the regex and the handler */
-        class RegexConverterElement {
-        private:
-            std::regex m_regex;
-            Handler * m_handler;
+        /** Builds a T from a line, if the line matches the regex */
+        using Parser = std::optional<T>(std::string_view);
 
-        public:
-            RegexConverterElement(const char * regex, Handler * handler)
-                : m_regex(regex), m_handler(handler) {}
+        /** Individual handler, with the literal its lines start with */
+        struct Entry {
+            std::string_view keyword;
+            Parser * parser;
+            /** Rank of the handler in the registration order */
+            std::size_t order;
+        };
 
-            std::optional<T> operator()(const std::string & str) const {
-                std::smatch smatch;
-                const bool r = std::regex_search(str, smatch, m_regex);
+        template <typename Method> struct HandlerTraits;
 
-                if (!r) return std::nullopt;
+        template <typename Class, typename Return, typename... Fields>
+        struct HandlerTraits<Return (Class::*)(Fields...) const> {
+            using FieldsTuple = std::tuple<std::decay_t<Fields>...>;
+        };
 
-                std::vector<std::string> values;
+        template <typename Field>
+        [[nodiscard]] static Field to_field(std::string_view capture) {
+            if constexpr (std::is_same_v<Field, std::string_view>) {
+                return capture;
+            } else if constexpr (std::is_same_v<Field, std::string>) {
+                return std::string(capture);
+            } else if constexpr (std::is_same_v<Field, char>) {
+                return capture.empty() ? '\0' : capture[0];
+            } else {
+                static_assert(std::is_integral_v<Field>, "Handler parameters must be integers, chars or strings");
+                return to_int<Field>(capture);
+            }
+        }
 
-                for (int i = 1 ; i != smatch.length() ; ++i) {
-                    values.emplace_back(smatch[i].str());
-                }
+        template <static_regex::FixedString Regex, typename Handler>
+        static std::optional<T> parse(std::string_view line) {
+            using Regex_ = StaticRegex<static_regex::Pattern<Regex>>;
+            using Fields = typename HandlerTraits<decltype(&Handler::operator())>::FieldsTuple;
+            static_assert(std::tuple_size_v<Fields> <= Regex_::Nb_Groups, "The handler has more parameters than the regex has groups");
 
-                return m_handler(values);
-            }
-        };
+            const auto captures = Regex_().search(line);
+            if (!captures) return std::nullopt;
+
+            return [&]<std::size_t... I>(std::index_sequence<I...>) -> T {
+                return Handler()(to_field<std::tuple_element_t<I, Fields>>((*captures)[I])...);
+            }(std::make_index_sequence<std::tuple_size_v<Fields>>());
+        }
+
+        [[nodiscard]] static std::string_view first_word(std::string_view str) {
+            return str.substr(0, str.find(' '));
+        }
 
     private:
-        std::vector<RegexConverterElement> m_handlers;
+        /** Handlers whose keyword is at least a whole word, by first word */
+        std::unordered_map<std::string_view, std::vector<Entry>> m_by_first_word;
+        /** Handlers that can not be indexed */
+        std::vector<Entry> m_others;
+        std::size_t m_nb_handlers = 0;
 
     public:
-        /** Adds a handler for a regex, with the given constructor */
-        void add_handler(const char * regex, Handler * handler) {
-            m_handlers.emplace_back(regex, handler);
+        /**
+         * Adds a handler for a regex, with the given constructor.
+         *
+         * The handler must be a lambda without captures. Its parameters are
+         * built from the captured groups, in order.
+         */
+        template <static_regex::FixedString Regex, typename Handler>
+        void add_handler(Handler) {
+            static_assert(std::is_default_constructible_v<Handler>, "Handlers must be lambdas without captures");
+
+            constexpr std::string_view keyword = StaticRegex<static_regex::Pattern<Regex>>::Leading_Literal;
+            const Entry entry { keyword, &parse<Regex, Handler>, m_nb_handlers++ };
+
+            if (keyword.find(' ') != std::string_view::npos) {
+                m_by_first_word[first_word(keyword)].push_back(entry);
+            } else {
+                m_others.push_back(entry);
+            }
         }
 
-        /** If a T can be built from the string, build it and return it */
-        std::optional<T> operator()(const std::string & str) const {
-            for (const auto & h : m_handlers) {
-                const auto e = h(str);
-                if (e) return e;
+        /**
+         * If a T can be built from the string, build it and return it.
+         *
+         * When several handlers match, the first registered one wins: the
+         * indexed and the other handlers are tried in registration order.
+         */
+        std::optional<T> operator()(std::string_view str) const {
+            static const std::vector<Entry> no_entries;
+            const auto it = m_by_first_word.find(first_word(str));
+            const std::vector<Entry> & indexed = it != m_by_first_word.end() ? it->second : no_entries;
+
+            auto indexed_it = indexed.begin();
+            auto others_it  = m_others.begin();
+
+            while (indexed_it != indexed.end() || others_it != m_others.end()) {
+                const bool take_indexed = others_it == m_others.end()
+                    || (indexed_it != indexed.end() && indexed_it->order < others_it->order);
+                const Entry & entry = take_indexed ? *indexed_it++ : *others_it++;
+
+                if (!str.starts_with(entry.keyword)) continue;
+                if (auto e = entry.parser(str)) return e;
             }
 
             return std::nullopt;
@@ -70,9 +143,10 @@ namespace bj {
          */
         std::optional<std::vector<T>> operator()(const std::vector<std::string> & lines) const {
             std::vector<T> elements;
+            elements.reserve(lines.size());
 
             for (const auto & line : lines) {
-                const auto opt_e = this->operator()(line);
+                auto opt_e = this->operator()(std::string_view(line));
                 if (!opt_e) {
                     std::cerr << "Bad input\n" << line << "\n";
                     return std::nullopt;
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+// Runtime selection of the instruction set used by the hot loops.
+//
+// The binary is compiled for the baseline x86-64 (SSE2). A hot loop is given
+// to bj::isa::dispatch, that runs it through a trampoline compiled for the
+// selected level: the trampoline is flattened, so the loop and everything it
+// calls are compiled (and vectorized) again for every level.
+//
+// const size_t total = bj::isa::dispatch([&]() { return count(words); });
+//
+// The level is the best one supported by the processor, or the one given
+// with --isa.
+
+namespace bj::isa {
+    enum class Level : std::uint8_t {
+        Baseline,   // x86-64: SSE2
+        SSE4_2,     // x86-64-v2: SSSE3, SSE4.2, POPCNT
+        AVX2,       // x86-64-v3: AVX2, BMI2, FMA
+        AVX512      // x86-64-v4: AVX-512 F, BW, DQ, VL
+    };
+
+    inline constexpr std::array<std::string_view, 4> Level_Names { "baseline", "sse4.2", "avx2", "avx512" };
+
+    [[nodiscard]] constexpr std::string_view name(Level level) noexcept {
+        return Level_Names[static_cast<std::size_t>(level)];
+    }
+
+    [[nodiscard]] constexpr std::optional<Level> from_name(std::string_view name) noexcept {
+        for (std::size_t i = 0 ; i != Level_Names.size() ; ++i) {
+            if (Level_Names[i] == name) return static_cast<Level>(i);
+        }
+        return std::nullopt;
+    }
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define BJ_ISA_SSE4_2 "ssse3,sse4.1,sse4.2,popcnt"
+#define BJ_ISA_AVX2   BJ_ISA_SSE4_2 ",avx,avx2,bmi,bmi2,fma,lzcnt,movbe,f16c"
+#define BJ_ISA_AVX512 BJ_ISA_AVX2 ",avx512f,avx512bw,avx512cd,avx512dq,avx512vl"
+
+    /** The best level supported by the processor */
+    [[nodiscard]] inline Level detect() noexcept {
+        __builtin_cpu_init();
+
+        const bool sse4_2 = __builtin_cpu_supports("ssse3") && __builtin_cpu_supports("sse4.2")
+            && __builtin_cpu_supports("popcnt");
+        const bool avx2 = sse4_2 && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2")
+            && __builtin_cpu_supports("fma");
+        const bool avx512 = avx2 && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+            && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl");
+
+        if (avx512) return Level::AVX512;
+        if (avx2)   return Level::AVX2;
+        if (sse4_2) return Level::SSE4_2;
+        return Level::Baseline;
+    }
+#else
+    [[nodiscard]] inline Level detect() noexcept { return Level::Baseline; }
+#endif
+
+    namespace details {
+        inline Level & selected() noexcept {
+            static Level level = detect();
+            return level;
+        }
+    }
+
+    /** The level used by dispatch */
+    [[nodiscard]] inline Level current() noexcept { return details::selected(); }
+
+    /**
+     * Forces the level used by dispatch. Returns false if the processor does
+     * not support it.
+     */
+    inline bool force(Level level) noexcept {
+        if (level > detect()) return false;
+        details::selected() = level;
+        return true;
+    }
+
+#if defined(__GNUC__) && defined(__x86_64__)
+    namespace details {
+        template <typename Function>
+        __attribute__((flatten)) decltype(auto) run_baseline(Function & function) { return function(); }
+
+        template <typename Function>
+        __attribute__((target(BJ_ISA_SSE4_2), flatten)) decltype(auto) run_sse4_2(Function & function) { return function(); }
+
+        template <typename Function>
+        __attribute__((target(BJ_ISA_AVX2), flatten)) decltype(auto) run_avx2(Function & function) { return function(); }
+
+        template <typename Function>
+        __attribute__((target(BJ_ISA_AVX512), flatten)) decltype(auto) run_avx512(Function & function) { return function(); }
+    }
+
+    /** Calls function(), compiled for the current level */
+    template <typename Function>
+    decltype(auto) dispatch(Function && function) {
+        switch (current()) {
+            case Level::AVX512: return details::run_avx512(function);
+            case Level::AVX2:   return details::run_avx2(function);
+            case Level::SSE4_2: return details::run_sse4_2(function);
+            case Level::Baseline: break;
+        }
+
+        return details::run_baseline(function);
+    }
+
+#undef BJ_ISA_AVX512
+#undef BJ_ISA_AVX2
+#undef BJ_ISA_SSE4_2
+#else
+    template <typename Function>
+    decltype(auto) dispatch(Function && function) { return function(); }
+#endif
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "flat_hash.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// Finds k values of a list whose sum is a target. Each value of the list is
+// used at most once.
+//
+// const std::optional<std::vector<long long>> terms = bj::k_sum::find(numbers, 3, 2020LL);
+//
+// The strategy depends on k and on the values:
+// - k = 2: one pass that remembers the values already seen, in a bitmap
+//   when the values are in a small range, else in a hash set. O(n).
+// - k = 3: the values are sorted, and for each value a two pointers sweep
+//   on the greater ones looks for the two others. O(n²).
+// - k >= 4: meet in the middle. The sums of the combinations of k / 2
+//   values are indexed, then each combination of the k - k / 2 other
+//   values looks for its complement. O(n^(k - k / 2)) time and
+//   O(n^(k / 2)) memory.
+//
+// The sums are computed with Int: it must be wide enough.
+
+namespace bj::k_sum {
+    /** Up to this range of values, k = 2 remembers the values in a bitmap */
+    static constexpr std::uint64_t Max_Bitmap_Range = std::uint64_t(1) << 26;
+
+    namespace details {
+        template <typename Int>
+        [[nodiscard]] std::optional<std::vector<Int>> two_sum_bitmap(const std::vector<Int> & values, Int target, Int min, Int max) {
+            std::vector<std::uint64_t> seen(static_cast<std::size_t>(max - min) / 64 + 1, 0);
+
+            for (const Int value : values) {
+                const Int wanted = target - value;
+                if (wanted >= min && wanted <= max) {
+                    const auto bit = static_cast<std::uint64_t>(wanted - min);
+                    if ((seen[bit / 64] >> (bit % 64)) & 1) return std::vector<Int> { wanted, value };
+                }
+
+                const auto bit = static_cast<std::uint64_t>(value - min);
+                seen[bit / 64] |= std::uint64_t(1) << (bit % 64);
+            }
+
+            return std::nullopt;
+        }
+
+        template <typename Int>
+        [[nodiscard]] std::optional<std::vector<Int>> two_sum_hash(const std::vector<Int> & values, Int target) {
+            bj::FlatHashSet<Int> seen;
+            seen.reserve(values.size());
+
+            for (const Int value : values) {
+                if (seen.contains(target - value)) return std::vector<Int> { target - value, value };
+                seen.insert(value);
+            }
+
+            return std::nullopt;
+        }
+
+        /** values must be sorted */
+        template <typename Int>
+        [[nodiscard]] std::optional<std::vector<Int>> three_sum_sorted(const std::vector<Int> & values, Int target) {
+            for (std::size_t first = 0 ; first + 2 < values.size() ; ++first) {
+                if (first != 0 && values[first] == values[first - 1]) continue;
+
+                const Int rest = target - values[first];
+                std::size_t left = first + 1;
+                std::size_t right = values.size() - 1;
+
+                while (left < right) {
+                    const Int sum = values[left] + values[right];
+                    if (sum < rest) {
+                        ++left;
+                    } else if (sum > rest) {
+                        --right;
+                    } else {
+                        return std::vector<Int> { values[first], values[left], values[right] };
+                    }
+                }
+            }
+
+            return std::nullopt;
+        }
+
+        /** Calls consumer(indices, sum) for every combination of size indices, in increasing order */
+        template <typename Int, typename Consumer>
+        void for_each_combination(const std::vector<Int> & values, std::size_t size, Consumer consumer) {
+            std::vector<std::size_t> indices;
+            indices.reserve(size);
+
+            const auto recurse = [&](const auto & self, std::size_t from, Int sum) -> bool {
+                if (indices.size() == size) return consumer(std::as_const(indices), sum);
+
+                for (std::size_t i = from ; i + (size - indices.size()) <= values.size() ; ++i) {
+                    indices.push_back(i);
+                    const bool stop = self(self, i + 1, sum + values[i]);
+                    indices.pop_back();
+                    if (stop) return true;
+                }
+
+                return false;
+            };
+
+            recurse(recurse, 0, Int {});
+        }
+
+        template <typename Int>
+        [[nodiscard]] std::optional<std::vector<Int>> meet_in_the_middle(const std::vector<Int> & values, std::size_t k, Int target) {
+            // A solution i_1 < ... < i_k is found as a left combination of its
+            // first k / 2 indices, and a right one of the others: the last
+            // index of the left part is lower than the first of the right one.
+            const std::size_t left_size  = k / 2;
+            const std::size_t right_size = k - left_size;
+
+            // Sum -> the left combination with this sum that ends the earliest
+            bj::FlatHashMap<Int, std::vector<std::size_t>> lefts;
+            for_each_combination(values, left_size, [&](const std::vector<std::size_t> & indices, Int sum) {
+                const auto [it, inserted] = lefts.try_emplace(sum, indices);
+                if (!inserted && indices.back() < it->second.back()) it->second = indices;
+                return false;
+            });
+
+            std::optional<std::vector<Int>> retval;
+            for_each_combination(values, right_size, [&](const std::vector<std::size_t> & indices, Int sum) {
+                const auto it = lefts.find(target - sum);
+                if (it == lefts.end() || it->second.back() >= indices.front()) return false;
+
+                retval.emplace();
+                for (const std::size_t i : it->second) retval->push_back(values[i]);
+                for (const std::size_t i : indices)    retval->push_back(values[i]);
+                return true;
+            });
+
+            return retval;
+        }
+    }
+
+    /** k values of the list whose sum is target, std::nullopt if there are none */
+    template <typename Int>
+    [[nodiscard]] std::optional<std::vector<Int>> find(std::vector<Int> values, std::size_t k, Int target) {
+        if (k > values.size()) return std::nullopt;
+
+        if (k == 0) {
+            if (target != Int {}) return std::nullopt;
+            return std::vector<Int> {};
+        }
+
+        if (k == 1) {
+            if (std::find(values.begin(), values.end(), target) == values.end()) return std::nullopt;
+            return std::vector<Int> { target };
+        }
+
+        if (k == 2) {
+            const auto [min, max] = std::minmax_element(values.begin(), values.end());
+            if (static_cast<std::uint64_t>(*max - *min) < Max_Bitmap_Range) {
+                return details::two_sum_bitmap(values, target, *min, *max);
+            } else {
+                return details::two_sum_hash(values, target);
+            }
+        }
+
+        if (k == 3) {
+            std::sort(values.begin(), values.end());
+            return details::three_sum_sorted(values, target);
+        }
+
+        return details::meet_in_the_middle(values, k, target);
+    }
+}
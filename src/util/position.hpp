@@ -1,4 +1,6 @@
 #pragma once
+#include "stencil.hpp"
+#include <array>
 #include <optional>
 
 namespace bj {
@@ -25,6 +27,8 @@ namespace bj {
             return false;
         }
 
+        [[nodiscard]] bool operator==(const Position & rhs) const = default;
+
         void move(Direction direction) {
             switch (direction) {
                 case Direction::Left:   x -= 1; break;
@@ -43,14 +47,13 @@ namespace bj {
             }
         }
         
-        [[nodiscard]] std::vector<bj::Position> get_8_neighbours() const {
-            std::vector<bj::Position> retval;
+        [[nodiscard]] std::array<bj::Position, 8> get_8_neighbours() const {
+            std::array<bj::Position, 8> retval;
 
-            for (int x_ = -1 ; x_ <= 1 ; ++x_) {
-            for (int y_ = -1 ; y_ <= 1 ; ++y_) {
-                if (y_ == 0 && x_ == 0) continue;
-                retval.push_back(Position { x + x_, y + y_ });
-            }}
+            for (size_t i = 0 ; i != retval.size() ; ++i) {
+                const auto & offset = bj::stencil::moore<2>[i];
+                retval[i] = Position { x + offset[0], y + offset[1] };
+            }
 
             return retval;
         }
@@ -1,28 +1,34 @@
 #pragma once
 
-#include <regex>
+#include "static_regex.hpp"
+#include <iostream>
+#include <string>
 #include <vector>
 
 namespace bj {
+    /**
+     * Builds a T from each line, by calling its constructor with the groups
+     * captured by T::Regex_Pattern. The pattern is compiled at compile time
+     * (see static_regex.hpp) and the captures are views on the lines.
+     */
     template <typename T>
     std::vector<T> lines_to_class_by_regex(const std::vector<std::string> & lines) {
-        std::regex regex_ { T::Regex_Pattern };
-        std::smatch smatch;
+        const StaticRegex<T> regex_;
 
         std::vector<T> retval;
+        retval.reserve(lines.size());
 
         for (const auto & line : lines) {
-            std::regex_search(line, smatch, regex_);
+            const auto captures = regex_.search(line);
 
-            std::vector<std::string> values;
-
-            for (int i = 1 ; i != smatch.length() ; ++i) {
-                values.emplace_back(smatch[i].str());
+            if (!captures) {
+                std::cerr << "Bad input\n" << line << "\n";
+                continue;
             }
 
-            retval.emplace_back(values);
+            retval.emplace_back(RegexCaptures(*captures));
         }
 
         return retval;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,345 @@
+#pragma once
+
+#include "flat_hash.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory_resource>
+#include <optional>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Searches in implicit graphs of states.
+//
+// A problem is described by functions:
+// - encode(state) returns a small key that identifies the state (ideally an
+//   integer). Two states with the same key are considered the same.
+// - expand(state, emit) calls emit(next_state) for every neighbour, or
+//   emit(next_state, cost) for the weighted searches.
+// - is_goal(state) tells if the search is over.
+//
+// const auto found = bj::search::breadth_first(start, encode, expand, is_goal);
+// if (found) return found->cost;
+
+namespace bj::search {
+    /** How a search is run */
+    struct Options {
+        /** Keep the parent of every state, to return the path to the goal */
+        bool track_path = false;
+        /**
+         * Expand the states of a BFS level on the shared thread pool.
+         * expand and encode are then called from several threads at once.
+         */
+        bool parallel = false;
+        /**
+         * Where the nodes, the visited tables and the queues are allocated,
+         * for example the arena of the day. It is only used from the
+         * calling thread.
+         */
+        std::pmr::memory_resource * memory_resource = std::pmr::get_default_resource();
+    };
+
+    /** A reached goal */
+    template <typename State, typename Cost>
+    struct Found {
+        State state;
+        Cost cost;
+        /** start ... state, only filled if Options::track_path */
+        std::vector<State> path;
+    };
+
+    namespace details {
+        static constexpr std::size_t No_Parent = std::numeric_limits<std::size_t>::max();
+
+        template <typename State>
+        struct Node {
+            State state;
+            std::size_t parent;
+        };
+
+        template <typename Nodes>
+        [[nodiscard]] auto rebuild_path(const Nodes & nodes, std::size_t index) {
+            std::vector<std::decay_t<decltype(nodes[index].state)>> path;
+            for (; index != No_Parent ; index = nodes[index].parent) {
+                path.push_back(nodes[index].state);
+            }
+
+            std::reverse(path.begin(), path.end());
+            return path;
+        }
+
+        template <typename Encode, typename State>
+        using KeyOf = std::decay_t<std::invoke_result_t<Encode &, const State &>>;
+
+        template <typename Key>
+        using Visited = bj::FlatHashSet<Key, bj::Hash<Key>, std::pmr::polymorphic_allocator<Key>>;
+
+        template <typename Key, typename Value>
+        using VisitedMap = bj::FlatHashMap<Key, Value, bj::Hash<Key>, std::pmr::polymorphic_allocator<std::pair<Key, Value>>>;
+    }
+
+    /**
+     * Breadth first search: finds a goal reached with the least number of
+     * moves.
+     *
+     * The states are processed level by level. In parallel mode, the states
+     * of a level are expanded on the shared thread pool and the new states
+     * are merged in order, so the result is the same as in sequential mode.
+     * expand and encode must then be safe to call concurrently: they must
+     * not modify shared data without synchronization. is_goal is only
+     * called from the calling thread.
+     */
+    template <typename State, typename Encode, typename Expand, typename IsGoal>
+    [[nodiscard]] std::optional<Found<State, std::size_t>> breadth_first(
+        State start, Encode encode, Expand expand, IsGoal is_goal, Options options = {}
+    ) {
+        using Key  = details::KeyOf<Encode, State>;
+        using Node = details::Node<State>;
+
+        struct Candidate {
+            Key key;
+            Node node;
+        };
+
+        // Levels that were already expanded, only kept to rebuild the path
+        std::pmr::vector<Node> archive(options.memory_resource);
+        details::Visited<Key> visited(options.memory_resource);
+
+        const auto found_at = [&](Node node, std::size_t depth) {
+            Found<State, std::size_t> found { node.state, depth, {} };
+            if (options.track_path) {
+                found.path = details::rebuild_path(archive, node.parent);
+                found.path.push_back(node.state);
+            }
+            return found;
+        };
+
+        visited.insert(encode(start));
+        if (is_goal(start)) return found_at(Node { std::move(start), details::No_Parent }, 0);
+
+        std::pmr::vector<Node> level(options.memory_resource);
+        std::pmr::vector<Node> next_level(options.memory_resource);
+        level.push_back(Node { std::move(start), details::No_Parent });
+
+        for (std::size_t depth = 1 ; !level.empty() ; ++depth) {
+            // Index of level[i] in the archive
+            const std::size_t base = archive.size();
+            if (options.track_path) archive.insert(archive.end(), level.begin(), level.end());
+
+            next_level.clear();
+            std::optional<Node> goal;
+
+            // Keeps the candidate if its state is new. Returns true to stop.
+            const auto accept = [&](Candidate && candidate) {
+                if (!visited.insert(candidate.key).second) return false;
+
+                if (is_goal(candidate.node.state)) {
+                    goal = std::move(candidate.node);
+                    return true;
+                }
+
+                next_level.push_back(std::move(candidate.node));
+                return false;
+            };
+
+            if (options.parallel && ThreadPool::shared().size() > 1 && level.size() > 1) {
+                // Filled by the pool threads, so not in options.memory_resource
+                const std::size_t nb_chunks = std::min(level.size(), ThreadPool::shared().size() * 4);
+                std::vector<std::vector<Candidate>> chunks(nb_chunks);
+
+                ThreadPool::shared().parallel_for(nb_chunks, [&](std::size_t chunk) {
+                    const std::size_t first = level.size() * chunk / nb_chunks;
+                    const std::size_t last  = level.size() * (chunk + 1) / nb_chunks;
+                    for (std::size_t i = first ; i != last ; ++i) {
+                        expand(std::as_const(level[i].state), [&](State next) {
+                            Key key = encode(next);
+                            chunks[chunk].push_back(Candidate { std::move(key), Node { std::move(next), base + i } });
+                        });
+                    }
+                });
+
+                for (std::vector<Candidate> & chunk : chunks) {
+                    for (Candidate & candidate : chunk) {
+                        if (accept(std::move(candidate))) return found_at(std::move(*goal), depth);
+                    }
+                }
+            } else {
+                for (std::size_t i = 0 ; i != level.size() && !goal ; ++i) {
+                    expand(std::as_const(level[i].state), [&](State next) {
+                        if (goal) return;
+                        Key key = encode(next);
+                        accept(Candidate { std::move(key), Node { std::move(next), base + i } });
+                    });
+                }
+
+                if (goal) return found_at(std::move(*goal), depth);
+            }
+
+            level.swap(next_level);
+        }
+
+        return std::nullopt;
+    }
+
+    /**
+     * Bidirectional breadth first search: the least number of moves between
+     * start and goal.
+     *
+     * expand_backward(state, emit) must emit the states from which state is
+     * reachable in one move (expand itself if the moves are reversible).
+     * The smallest frontier is expanded first, so both searches only need
+     * to reach about half the distance.
+     */
+    template <typename State, typename Encode, typename Expand, typename ExpandBackward>
+    [[nodiscard]] std::optional<std::size_t> bidirectional_breadth_first(
+        const State & start, const State & goal,
+        Encode encode, Expand expand, ExpandBackward expand_backward
+    ) {
+        using Key = details::KeyOf<Encode, State>;
+
+        struct Side {
+            bj::FlatHashMap<Key, std::size_t> depth_of;
+            std::vector<State> level;
+            std::size_t depth = 0;
+        };
+
+        Side forward;
+        Side backward;
+
+        const Key start_key = encode(start);
+        const Key goal_key  = encode(goal);
+        if (start_key == goal_key) return 0;
+
+        forward.depth_of.try_emplace(start_key, 0);
+        forward.level.push_back(start);
+        backward.depth_of.try_emplace(goal_key, 0);
+        backward.level.push_back(goal);
+
+        // Expands one full level of side, returns the best meeting distance
+        const auto expand_level = [&](Side & side, const Side & other, auto & side_expand) {
+            std::optional<std::size_t> best;
+            std::vector<State> next_level;
+            ++side.depth;
+
+            for (const State & state : side.level) {
+                side_expand(state, [&](State next) {
+                    Key key = encode(next);
+                    if (!side.depth_of.try_emplace(key, side.depth).second) return;
+
+                    if (const auto it = other.depth_of.find(key); it != other.depth_of.end()) {
+                        const std::size_t distance = side.depth + it->second;
+                        if (!best || distance < *best) best = distance;
+                    }
+
+                    next_level.push_back(std::move(next));
+                });
+            }
+
+            side.level = std::move(next_level);
+            return best;
+        };
+
+        while (!forward.level.empty() && !backward.level.empty()) {
+            const std::optional<std::size_t> met = forward.level.size() <= backward.level.size()
+                ? expand_level(forward, backward, expand)
+                : expand_level(backward, forward, expand_backward);
+
+            if (met) return met;
+        }
+
+        return std::nullopt;
+    }
+
+    /**
+     * A*: finds a goal reached with the least total cost.
+     *
+     * expand(state, emit) calls emit(next_state, cost) with non negative
+     * costs. heuristic(state) must never overestimate the remaining cost
+     * to a goal, else the returned goal may not be the best one.
+     */
+    template <typename State, typename Encode, typename Expand, typename IsGoal, typename Heuristic>
+    [[nodiscard]] auto a_star(
+        State start, Encode encode, Expand expand, IsGoal is_goal, Heuristic heuristic, Options options = {}
+    ) {
+        using Key  = details::KeyOf<Encode, State>;
+        using Cost = std::decay_t<std::invoke_result_t<Heuristic &, const State &>>;
+
+        struct Node {
+            State state;
+            std::size_t parent;
+            Cost cost;
+        };
+
+        struct Queued {
+            Cost estimate;          // cost + heuristic
+            Cost cost;
+            std::size_t node;
+
+            // Ties go to the deepest state, that is probably closer to a goal,
+            // then to the most recent one
+            [[nodiscard]] bool operator>(const Queued & other) const noexcept {
+                if (estimate != other.estimate) return estimate > other.estimate;
+                if (cost != other.cost) return cost < other.cost;
+                return node < other.node;
+            }
+        };
+
+        std::pmr::vector<Node> nodes(options.memory_resource);
+        details::VisitedMap<Key, std::size_t> best_node(options.memory_resource);
+        std::priority_queue<Queued, std::pmr::vector<Queued>, std::greater<Queued>> queue(
+            std::greater<Queued>(), std::pmr::vector<Queued>(options.memory_resource)
+        );
+
+        const Cost start_estimate = heuristic(start);
+        best_node[encode(start)] = 0;
+        nodes.push_back(Node { std::move(start), details::No_Parent, Cost {} });
+        queue.push(Queued { start_estimate, Cost {}, 0 });
+
+        std::optional<Found<State, Cost>> retval;
+
+        while (!queue.empty()) {
+            const std::size_t index = queue.top().node;
+            queue.pop();
+
+            // A better path to the state was found after this one was queued
+            if (best_node.find(encode(nodes[index].state))->second != index) continue;
+
+            if (is_goal(std::as_const(nodes[index].state))) {
+                retval = Found<State, Cost> { nodes[index].state, nodes[index].cost, {} };
+                if (options.track_path) retval->path = details::rebuild_path(nodes, index);
+                break;
+            }
+
+            const State current = nodes[index].state;
+            const Cost current_cost = nodes[index].cost;
+
+            expand(current, [&](State next, Cost move_cost) {
+                const Cost cost = current_cost + move_cost;
+                const auto [it, inserted] = best_node.try_emplace(encode(next), nodes.size());
+                if (!inserted) {
+                    if (nodes[it->second].cost <= cost) return;
+                    it->second = nodes.size();
+                }
+
+                const Cost estimate = cost + heuristic(std::as_const(next));
+                nodes.push_back(Node { std::move(next), index, cost });
+                queue.push(Queued { estimate, cost, nodes.size() - 1 });
+            });
+        }
+
+        return retval;
+    }
+
+    /** Dijkstra: A* without heuristic */
+    template <typename Cost = std::size_t, typename State, typename Encode, typename Expand, typename IsGoal>
+    [[nodiscard]] auto dijkstra(State start, Encode encode, Expand expand, IsGoal is_goal, Options options = {}) {
+        return a_star(
+            std::move(start), std::move(encode), std::move(expand), std::move(is_goal),
+            [](const State &) { return Cost {}; }, options
+        );
+    }
+}
@@ -0,0 +1,581 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace bj {
+    /** Captured groups of a regex. Groups that did not participate are empty. */
+    using RegexCaptures = std::span<const std::string_view>;
+
+    /**
+     * A regex engine whose patterns are compiled at compile time, for the
+     * subset of the syntax used by the days:
+     * - Literals, escaped characters (`\.`), `.`, `\d`, `\w` and `\s`
+     * - Character classes, with ranges and negation (`[^a-z\-]`)
+     * - Greedy `*`, `+` and `?`, on characters, classes and groups
+     * - Capturing groups and alternations (`(\+|-)`)
+     * - `^` and `$` anchors
+     *
+     * Unbalanced parentheses, a quantifier with nothing to repeat and
+     * unescaped braces (`{n}` repetitions) are compilation errors. Other
+     * escapes (`\b`, `\1`...) match the escaped character literally.
+     *
+     * Patterns are compiled into a small backtracking virtual machine, see
+     * "Regular Expression Matching: the Virtual Machine Approach" by Russ
+     * Cox. Repetitions of a single character class are a single instruction
+     * that greedily eats the input and only then backtracks.
+     *
+     * A sub-pattern that can match the empty string must not be repeated
+     * with `*` or `+`, as it would loop forever.
+     */
+    namespace static_regex {
+        enum class Op : std::uint8_t {
+            /** Matches a string of the literal pool */
+            Literal,
+            /** Matches between min and max characters of the class */
+            Class,
+            /** Tries x, then y if x failed */
+            Split,
+            /** Goes to x */
+            Jump,
+            /** Saves the current position in the capture slot x */
+            Save,
+            /** ^ */
+            LineBegin,
+            /** $ */
+            LineEnd,
+            /** The whole pattern has been matched */
+            Match
+        };
+
+        struct CharClass {
+            std::array<std::uint64_t, 4> bits {};
+
+            constexpr void add(char c) {
+                const auto u = static_cast<unsigned char>(c);
+                bits[u / 64] |= std::uint64_t(1) << (u % 64);
+            }
+
+            constexpr void add_range(char from, char to) {
+                for (int c = static_cast<unsigned char>(from) ; c <= static_cast<unsigned char>(to) ; ++c) {
+                    add(static_cast<char>(c));
+                }
+            }
+
+            constexpr void negate() {
+                for (auto & word : bits) word = ~word;
+            }
+
+            [[nodiscard]] constexpr bool contains(char c) const noexcept {
+                const auto u = static_cast<unsigned char>(c);
+                return (bits[u / 64] >> (u % 64)) & 1;
+            }
+        };
+
+        static constexpr std::size_t Unbounded = static_cast<std::size_t>(-1);
+
+        struct Instruction {
+            Op op = Op::Match;
+            // Literal
+            std::size_t literal_begin = 0;
+            std::size_t literal_size  = 0;
+            // Class
+            CharClass   char_class {};
+            std::size_t min = 1;
+            std::size_t max = 1;
+            // Split, Jump and Save
+            std::size_t x = 0;
+            std::size_t y = 0;
+        };
+
+        /** Number of capturing groups in the pattern */
+        [[nodiscard]] constexpr std::size_t count_groups(std::string_view pattern) {
+            std::size_t groups = 0;
+            bool in_class = false;
+
+            for (std::size_t i = 0 ; i < pattern.size() ; ++i) {
+                if (pattern[i] == '\\') {
+                    ++i;
+                } else if (in_class) {
+                    in_class = pattern[i] != ']';
+                } else if (pattern[i] == '[') {
+                    in_class = true;
+                } else if (pattern[i] == '(') {
+                    ++groups;
+                }
+            }
+
+            return groups;
+        }
+
+        /** A compiled pattern */
+        template <std::size_t PatternLength, std::size_t NbGroups>
+        struct Program {
+            // Each character of the pattern produces at most 2 instructions
+            std::array<Instruction, 2 * PatternLength + 2> code {};
+            std::size_t size = 0;
+            std::array<char, PatternLength + 1> literals {};
+            std::size_t literals_size = 0;
+
+            [[nodiscard]] constexpr std::string_view literal(const Instruction & instruction) const {
+                return std::string_view(literals.data() + instruction.literal_begin, instruction.literal_size);
+            }
+        };
+
+        /** Recursive descent parser that produces the program */
+        template <std::size_t PatternLength, std::size_t NbGroups>
+        class Compiler {
+        private:
+            std::string_view m_pattern;
+            std::size_t m_pos = 0;
+            std::size_t m_next_group = 0;
+            Program<PatternLength, NbGroups> m_program;
+
+        public:
+            constexpr explicit Compiler(std::string_view pattern) : m_pattern(pattern) {}
+
+            constexpr Program<PatternLength, NbGroups> compile() {
+                parse_alternation();
+                if (m_pos != m_pattern.size()) throw "bj::static_regex: unbalanced parenthesis";
+                emit(Instruction { .op = Op::Match });
+                return m_program;
+            }
+
+        private:
+            [[nodiscard]] constexpr bool at_end() const { return m_pos == m_pattern.size(); }
+            [[nodiscard]] constexpr char peek(std::size_t offset = 0) const {
+                return m_pos + offset < m_pattern.size() ? m_pattern[m_pos + offset] : '\0';
+            }
+
+            [[nodiscard]] static constexpr bool is_quantifier(char c) { return c == '*' || c == '+' || c == '?'; }
+
+            constexpr std::size_t emit(Instruction instruction) {
+                m_program.code[m_program.size] = instruction;
+                return m_program.size++;
+            }
+
+            /**
+             * Inserts an instruction at the given position, and fixes the jumps
+             * over it. The jumps to the position that come from before it
+             * enter the inserted instruction, the ones from after it are loops
+             * back to the instruction that was there.
+             */
+            constexpr void insert_at(std::size_t at, Instruction instruction) {
+                for (std::size_t i = m_program.size ; i > at ; --i) {
+                    m_program.code[i] = m_program.code[i - 1];
+                }
+
+                ++m_program.size;
+
+                for (std::size_t i = 0 ; i != m_program.size ; ++i) {
+                    Instruction & other = m_program.code[i];
+                    if (other.op == Op::Split || other.op == Op::Jump) {
+                        if (other.x > at || (other.x == at && i > at)) ++other.x;
+                        if (other.y > at || (other.y == at && i > at)) ++other.y;
+                    }
+                }
+
+                m_program.code[at] = instruction;
+            }
+
+            // alternation := sequence ('|' sequence)*
+            constexpr void parse_alternation() {
+                std::size_t start = m_program.size;
+                parse_sequence();
+
+                std::array<std::size_t, PatternLength + 1> jumps_to_end {};
+                std::size_t nb_jumps = 0;
+
+                while (peek() == '|') {
+                    ++m_pos;
+
+                    insert_at(start, Instruction { .op = Op::Split, .x = start + 1 });
+                    jumps_to_end[nb_jumps++] = emit(Instruction { .op = Op::Jump });
+                    m_program.code[start].y = m_program.size;
+
+                    start = m_program.size;
+                    parse_sequence();
+                }
+
+                for (std::size_t i = 0 ; i != nb_jumps ; ++i) {
+                    m_program.code[jumps_to_end[i]].x = m_program.size;
+                }
+            }
+
+            // sequence := (atom quantifier?)*
+            constexpr void parse_sequence() {
+                while (!at_end() && peek() != '|' && peek() != ')') {
+                    parse_atom();
+                }
+            }
+
+            constexpr void parse_atom() {
+                const char c = peek();
+
+                if (c == '(') {
+                    ++m_pos;
+                    const std::size_t group = m_next_group++;
+                    const std::size_t start = emit(Instruction { .op = Op::Save, .x = 2 * group });
+                    parse_alternation();
+                    if (peek() != ')') throw "bj::static_regex: unbalanced parenthesis";
+                    ++m_pos;
+                    emit(Instruction { .op = Op::Save, .x = 2 * group + 1 });
+                    parse_group_quantifier(start);
+                } else if (c == '^') {
+                    ++m_pos;
+                    emit(Instruction { .op = Op::LineBegin });
+                } else if (c == '$') {
+                    ++m_pos;
+                    emit(Instruction { .op = Op::LineEnd });
+                } else if (c == '[' || c == '.' || (c == '\\' && is_class_escape(peek(1)))) {
+                    Instruction instruction { .op = Op::Class, .char_class = parse_class() };
+                    parse_class_quantifier(instruction);
+                    emit(instruction);
+                } else if (is_quantifier(c)) {
+                    throw "bj::static_regex: nothing to repeat";
+                } else {
+                    parse_literals();
+                }
+            }
+
+            // A literal followed by a quantifier is a single character class.
+            // Else, all following literals that are not repeated are merged.
+            constexpr void parse_literals() {
+                const std::size_t literal_begin = m_program.literals_size;
+
+                while (!at_end()) {
+                    const std::size_t atom_size = peek() == '\\' ? 2 : 1;
+                    const char c = peek(atom_size - 1);
+
+                    if (atom_size == 1 && (c == '{' || c == '}')) throw "bj::static_regex: {n} repetitions are not supported, escape the braces";
+                    if (atom_size == 1 && (c == '(' || c == ')' || c == '|' || c == '[' || c == '.' || c == '^' || c == '$' || is_quantifier(c))) break;
+                    if (atom_size == 2 && is_class_escape(c)) break;
+
+                    if (is_quantifier(peek(atom_size))) {
+                        if (m_program.literals_size != literal_begin) break;
+
+                        m_pos += atom_size;
+                        Instruction instruction { .op = Op::Class };
+                        instruction.char_class.add(c);
+                        parse_class_quantifier(instruction);
+                        emit(instruction);
+                        return;
+                    }
+
+                    m_program.literals[m_program.literals_size++] = c;
+                    m_pos += atom_size;
+                }
+
+                emit(Instruction {
+                    .op = Op::Literal,
+                    .literal_begin = literal_begin,
+                    .literal_size = m_program.literals_size - literal_begin
+                });
+            }
+
+            [[nodiscard]] static constexpr bool is_class_escape(char c) {
+                return c == 'd' || c == 'w' || c == 's';
+            }
+
+            static constexpr void add_class_escape(CharClass & char_class, char c) {
+                if (c == 'd') {
+                    char_class.add_range('0', '9');
+                } else if (c == 'w') {
+                    char_class.add_range('a', 'z');
+                    char_class.add_range('A', 'Z');
+                    char_class.add_range('0', '9');
+                    char_class.add('_');
+                } else if (c == 's') {
+                    for (char space : { ' ', '\t', '\n', '\r', '\f', '\v' }) char_class.add(space);
+                } else {
+                    char_class.add(c);
+                }
+            }
+
+            constexpr CharClass parse_class() {
+                CharClass char_class;
+
+                if (peek() == '.') {
+                    ++m_pos;
+                    char_class.negate();
+                    return char_class;
+                }
+
+                if (peek() == '\\') {
+                    add_class_escape(char_class, peek(1));
+                    m_pos += 2;
+                    return char_class;
+                }
+
+                ++m_pos; // [
+                const bool negated = peek() == '^';
+                if (negated) ++m_pos;
+
+                bool first = true;
+                while (!at_end() && (first || peek() != ']')) {
+                    first = false;
+
+                    char from = peek();
+                    if (from == '\\') {
+                        ++m_pos;
+                        if (is_class_escape(peek())) {
+                            add_class_escape(char_class, peek());
+                            ++m_pos;
+                            continue;
+                        }
+                        from = peek();
+                    }
+                    ++m_pos;
+
+                    if (peek() == '-' && peek(1) != ']' && peek(1) != '\0') {
+                        ++m_pos;
+                        char to = peek();
+                        if (to == '\\') {
+                            ++m_pos;
+                            to = peek();
+                        }
+                        ++m_pos;
+                        char_class.add_range(from, to);
+                    } else {
+                        char_class.add(from);
+                    }
+                }
+
+                if (at_end()) throw "bj::static_regex: unterminated character class";
+                ++m_pos; // ]
+
+                if (negated) char_class.negate();
+                return char_class;
+            }
+
+            constexpr void parse_class_quantifier(Instruction & instruction) {
+                switch (peek()) {
+                    case '*': instruction.min = 0; instruction.max = Unbounded; break;
+                    case '+': instruction.min = 1; instruction.max = Unbounded; break;
+                    case '?': instruction.min = 0; instruction.max = 1;         break;
+                    default: return;
+                }
+
+                ++m_pos;
+                if (is_quantifier(peek())) throw "bj::static_regex: lazy and possessive quantifiers are not supported";
+            }
+
+            constexpr void parse_group_quantifier(std::size_t start) {
+                const char c = peek();
+                if (!is_quantifier(c)) return;
+                ++m_pos;
+                if (is_quantifier(peek())) throw "bj::static_regex: lazy and possessive quantifiers are not supported";
+
+                if (c == '?') {
+                    insert_at(start, Instruction { .op = Op::Split, .x = start + 1 });
+                    m_program.code[start].y = m_program.size;
+                } else if (c == '*') {
+                    insert_at(start, Instruction { .op = Op::Split, .x = start + 1 });
+                    emit(Instruction { .op = Op::Jump, .x = start });
+                    m_program.code[start].y = m_program.size;
+                } else /* if (c == '+') */ {
+                    emit(Instruction { .op = Op::Split, .x = start, .y = m_program.size + 1 });
+                }
+            }
+        };
+
+        /** Runs a program on a string */
+        template <std::size_t PatternLength, std::size_t NbGroups>
+        class Backtracker {
+        private:
+            static constexpr std::size_t Unset = static_cast<std::size_t>(-1);
+
+            const Program<PatternLength, NbGroups> & m_program;
+            std::string_view m_str;
+            std::array<std::size_t, 2 * NbGroups> m_slots {};
+
+        public:
+            constexpr Backtracker(const Program<PatternLength, NbGroups> & program, std::string_view str)
+            : m_program(program), m_str(str) {}
+
+            constexpr std::optional<std::array<std::string_view, NbGroups>> search() {
+                const bool anchored = m_program.code[0].op == Op::LineBegin;
+
+                for (std::size_t start = 0 ; start <= m_str.size() ; ++start) {
+                    m_slots.fill(Unset);
+
+                    if (run(0, start)) {
+                        std::array<std::string_view, NbGroups> captures {};
+                        for (std::size_t group = 0 ; group != NbGroups ; ++group) {
+                            const std::size_t from = m_slots[2 * group];
+                            const std::size_t to   = m_slots[2 * group + 1];
+                            if (from != Unset && to != Unset) {
+                                captures[group] = m_str.substr(from, to - from);
+                            }
+                        }
+                        return captures;
+                    }
+
+                    if (anchored) break;
+                }
+
+                return std::nullopt;
+            }
+
+        private:
+            constexpr bool run(std::size_t pc, std::size_t pos) {
+                while (true) {
+                    const Instruction & instruction = m_program.code[pc];
+
+                    switch (instruction.op) {
+                        case Op::Literal: {
+                            const std::string_view literal = m_program.literal(instruction);
+                            if (m_str.substr(pos, literal.size()) != literal) return false;
+                            pos += literal.size();
+                            ++pc;
+                            break;
+                        }
+                        case Op::Class: {
+                            std::size_t count = 0;
+                            while (count != instruction.max && pos + count < m_str.size()
+                                && instruction.char_class.contains(m_str[pos + count])) {
+                                ++count;
+                            }
+
+                            if (count < instruction.min) return false;
+
+                            if (count != instruction.min) {
+                                return backtrack_class(pc, pos, instruction.min, count);
+                            }
+
+                            pos += count;
+                            ++pc;
+                            break;
+                        }
+                        case Op::Split: {
+                            const auto slots = m_slots;
+                            if (run(instruction.x, pos)) return true;
+                            m_slots = slots;
+                            pc = instruction.y;
+                            break;
+                        }
+                        case Op::Jump:
+                            pc = instruction.x;
+                            break;
+                        case Op::Save:
+                            m_slots[instruction.x] = pos;
+                            ++pc;
+                            break;
+                        case Op::LineBegin:
+                            if (pos != 0) return false;
+                            ++pc;
+                            break;
+                        case Op::LineEnd:
+                            if (pos != m_str.size()) return false;
+                            ++pc;
+                            break;
+                        case Op::Match:
+                            return true;
+                    }
+                }
+            }
+
+            /** Tries to continue after eating from max to min characters */
+            constexpr bool backtrack_class(std::size_t pc, std::size_t pos, std::size_t min, std::size_t max) {
+                const Instruction & next = m_program.code[pc + 1];
+                const auto slots = m_slots;
+
+                for (std::size_t taken = max ; ; --taken) {
+                    const std::size_t next_pos = pos + taken;
+
+                    // Cheap rejection of the positions the next instruction can not accept
+                    const bool can_continue =
+                        next.op == Op::Literal ? next_pos < m_str.size() && m_str[next_pos] == m_program.literals[next.literal_begin]
+                        : next.op == Op::LineEnd ? next_pos == m_str.size()
+                        : true;
+
+                    if (can_continue) {
+                        if (run(pc + 1, next_pos)) return true;
+                        m_slots = slots;
+                    }
+
+                    if (taken == min) return false;
+                }
+            }
+        };
+
+        template <std::size_t PatternLength, std::size_t NbGroups>
+        [[nodiscard]] constexpr Program<PatternLength, NbGroups> compile(std::string_view pattern) {
+            return Compiler<PatternLength, NbGroups>(pattern).compile();
+        }
+
+        /** A string literal that can be used as a template parameter */
+        template <std::size_t N>
+        struct FixedString {
+            std::array<char, N> data {};
+
+            constexpr FixedString(const char (&str)[N]) {
+                for (std::size_t i = 0 ; i != N ; ++i) data[i] = str[i];
+            }
+
+            [[nodiscard]] constexpr std::string_view view() const { return std::string_view(data.data(), N - 1); }
+        };
+
+        /** Wraps a FixedString to be used as a StaticRegex pattern */
+        template <FixedString Regex>
+        struct Pattern {
+            static constexpr std::string_view Regex_Pattern = Regex.view();
+        };
+    }
+
+    /**
+     * The regex T::Regex_Pattern, compiled at compile time.
+     *
+     * search returns the captured groups if the pattern is found in the
+     * string.
+     */
+    template <typename T>
+    class StaticRegex {
+    private:
+        static constexpr std::string_view Pattern  = T::Regex_Pattern;
+        static constexpr std::size_t      NbGroups = static_regex::count_groups(Pattern);
+        static constexpr auto Program = static_regex::compile<Pattern.size(), NbGroups>(Pattern);
+
+    public:
+        using Captures = std::array<std::string_view, NbGroups>;
+
+        static constexpr std::size_t Nb_Groups = NbGroups;
+
+        /** The literal that starts every match if the pattern is anchored, else an empty string */
+        static constexpr std::string_view Leading_Literal =
+            Program.code[0].op == static_regex::Op::LineBegin && Program.code[1].op == static_regex::Op::Literal
+            ? Program.literal(Program.code[1]) : std::string_view();
+
+        [[nodiscard]] constexpr std::optional<Captures> search(std::string_view str) const {
+            return static_regex::Backtracker<Pattern.size(), NbGroups>(Program, str).search();
+        }
+    };
+
+    // Groups, quantifiers and alternations
+    namespace static_regex {
+        template <FixedString Regex>
+        [[nodiscard]] constexpr bool matches(std::string_view str) {
+            return StaticRegex<Pattern<Regex>>().search(str).has_value();
+        }
+
+        static_assert( matches<"^a(b|c)d$">("acd"));
+        static_assert(!matches<"^a(b|c)d$">("ad"));
+        static_assert( matches<"^(ab)+$">("ababab"));
+        static_assert(!matches<"^(ab)+$">(""));
+        static_assert( matches<"^x(ab)?y$">("xy"));
+        static_assert( matches<"^x(ab)?y$">("xaby"));
+        static_assert( matches<"^((a)*|b)$">("aa"));
+        static_assert( matches<"^((a)*|b)$">("b"));
+        static_assert(!matches<"^((a)*|b)$">("ab"));
+        static_assert(!matches<"^((a)*|b)$">("aab"));
+        static_assert( matches<"^((a)+|b)$">("aaa"));
+        static_assert(!matches<"^((a)+|b)$">("ab"));
+        static_assert(!matches<"^(b|(a)+)$">("ba"));
+        static_assert( matches<"^(\\d+)-(\\d+) (\\w): (\\w*)$">("1-3 a: abcde"));
+        static_assert(StaticRegex<Pattern<"(\\+|-)(\\d+)">>().search("x-12")->at(1) == "12");
+    }
+}
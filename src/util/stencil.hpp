@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+// Neighbourhoods as compile time tables of offsets.
+//
+// Iterating on a std::array of a size known at compile time lets the
+// compiler unroll the neighbour loops.
+//
+// for (const auto & offset : bj::stencil::moore<3>) { ... }
+
+namespace bj::stencil {
+    template <std::size_t NB_DIM>
+    using Offset = std::array<int, NB_DIM>;
+
+    namespace details {
+        [[nodiscard]] constexpr std::size_t power_of_3(std::size_t exponent) {
+            std::size_t result = 1;
+            for (std::size_t i = 0 ; i != exponent ; ++i) result *= 3;
+            return result;
+        }
+
+        template <std::size_t NB_DIM>
+        [[nodiscard]] constexpr auto make_moore() {
+            std::array<Offset<NB_DIM>, power_of_3(NB_DIM) - 1> offsets {};
+
+            std::size_t written = 0;
+            for (std::size_t code = 0 ; code != power_of_3(NB_DIM) ; ++code) {
+                // code in base 3, with digits 0, 1, 2 for -1, 0, +1
+                Offset<NB_DIM> offset {};
+                bool is_centre = true;
+
+                std::size_t rest = code;
+                for (std::size_t dim = 0 ; dim != NB_DIM ; ++dim) {
+                    offset[dim] = static_cast<int>(rest % 3) - 1;
+                    rest /= 3;
+                    is_centre = is_centre && offset[dim] == 0;
+                }
+
+                if (!is_centre) offsets[written++] = offset;
+            }
+
+            return offsets;
+        }
+
+        template <std::size_t NB_DIM>
+        [[nodiscard]] constexpr auto make_von_neumann() {
+            std::array<Offset<NB_DIM>, 2 * NB_DIM> offsets {};
+
+            for (std::size_t dim = 0 ; dim != NB_DIM ; ++dim) {
+                offsets[2 * dim    ][dim] = -1;
+                offsets[2 * dim + 1][dim] = +1;
+            }
+
+            return offsets;
+        }
+    }
+
+    /** The 3^NB_DIM - 1 cells around a cell, diagonals included */
+    template <std::size_t NB_DIM>
+    inline constexpr auto moore = details::make_moore<NB_DIM>();
+
+    /** The 2 * NB_DIM cells that share a face with a cell */
+    template <std::size_t NB_DIM>
+    inline constexpr auto von_neumann = details::make_von_neumann<NB_DIM>();
+
+    /**
+     * The 6 neighbours of a hexagon in axial coordinates (x, y): the Moore
+     * neighbourhood without the (-1, -1) and (+1, +1) diagonals.
+     */
+    inline constexpr std::array<Offset<2>, 6> hexagonal {{
+        { +1, 0 }, { +1, -1 }, { 0, -1 }, { -1, 0 }, { -1, +1 }, { 0, +1 }
+    }};
+
+    /**
+     * Offsets of a stencil in a flat row major buffer, where going to the
+     * next coordinate of dimension i moves by strides[i] cells.
+     */
+    template <std::size_t NB_DIM, std::size_t Size>
+    [[nodiscard]] constexpr std::array<std::ptrdiff_t, Size> to_linear(
+        const std::array<Offset<NB_DIM>, Size> & stencil,
+        const std::array<std::ptrdiff_t, NB_DIM> & strides
+    ) {
+        std::array<std::ptrdiff_t, Size> linear {};
+
+        for (std::size_t i = 0 ; i != Size ; ++i) {
+            for (std::size_t dim = 0 ; dim != NB_DIM ; ++dim) {
+                linear[i] += stencil[i][dim] * strides[dim];
+            }
+        }
+
+        return linear;
+    }
+
+    static_assert(moore<2>.size() == 8);
+    static_assert(moore<4>.size() == 80);
+    static_assert(to_linear(moore<2>, { 1, 10 })[0] == -11);
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <string_view>
+
+namespace bj {
+    /** Policy for the tokens that are empty (two consecutive delimiters) */
+    enum class EmptyTokens { Skip, Keep };
+
+    /**
+     * A range over the tokens of a string, separated by a (possibly multi
+     * character) delimiter.
+     *
+     * Tokens are std::string_view on the original string, so nothing is
+     * allocated but the string must outlive the iteration.
+     *
+     * for (const std::string_view ingredient : bj::split(line, ", ")) { ... }
+     */
+    class SplitView {
+    public:
+        class sentinel {};
+
+        class iterator {
+        private:
+            std::string_view m_rest;
+            std::string_view m_delimiter;
+            std::string_view m_token;
+            EmptyTokens      m_empty_tokens = EmptyTokens::Skip;
+            bool             m_last_token   = false;
+            bool             m_at_end       = false;
+
+            constexpr void find_next() {
+                do {
+                    if (m_last_token) {
+                        m_at_end = true;
+                        return;
+                    }
+
+                    const size_t pos = m_delimiter.empty() ? std::string_view::npos : m_rest.find(m_delimiter);
+
+                    if (pos == std::string_view::npos) {
+                        m_token = m_rest;
+                        m_rest = std::string_view();
+                        m_last_token = true;
+                    } else {
+                        m_token = m_rest.substr(0, pos);
+                        m_rest.remove_prefix(pos + m_delimiter.size());
+                    }
+                } while (m_empty_tokens == EmptyTokens::Skip && m_token.empty());
+            }
+
+        public:
+            using value_type        = std::string_view;
+            using difference_type   = std::ptrdiff_t;
+            using iterator_category = std::input_iterator_tag;
+
+            constexpr iterator() = default;
+            constexpr iterator(std::string_view str, std::string_view delimiter, EmptyTokens empty_tokens)
+            : m_rest(str), m_delimiter(delimiter), m_empty_tokens(empty_tokens) {
+                find_next();
+            }
+
+            [[nodiscard]] constexpr std::string_view operator*() const noexcept { return m_token; }
+
+            constexpr iterator & operator++() { find_next(); return *this; }
+            constexpr void operator++(int) { find_next(); }
+
+            /** Part of the string that has not been split yet */
+            [[nodiscard]] constexpr std::string_view rest() const noexcept { return m_rest; }
+
+            [[nodiscard]] constexpr bool operator==(sentinel) const noexcept { return m_at_end; }
+        };
+
+    private:
+        std::string_view m_str;
+        std::string_view m_delimiter;
+        EmptyTokens      m_empty_tokens;
+
+    public:
+        constexpr SplitView(std::string_view str, std::string_view delimiter, EmptyTokens empty_tokens)
+        : m_str(str), m_delimiter(delimiter), m_empty_tokens(empty_tokens) {}
+
+        [[nodiscard]] constexpr iterator begin() const { return iterator(m_str, m_delimiter, m_empty_tokens); }
+        [[nodiscard]] constexpr sentinel end() const noexcept { return sentinel{}; }
+    };
+
+    /** Splits str on every delimiter. Empty tokens are skipped by default. */
+    [[nodiscard]] constexpr SplitView split(
+        std::string_view str, std::string_view delimiter = " ", EmptyTokens empty_tokens = EmptyTokens::Skip
+    ) {
+        return SplitView(str, delimiter, empty_tokens);
+    }
+
+    /**
+     * Returns the first N tokens of the string. Missing tokens are empty.
+     *
+     * const auto [city1, _to, city2, _equal, distance] = bj::split_n<5>(line);
+     */
+    template <size_t N>
+    [[nodiscard]] constexpr std::array<std::string_view, N> split_n(
+        std::string_view str, std::string_view delimiter = " ", EmptyTokens empty_tokens = EmptyTokens::Skip
+    ) {
+        std::array<std::string_view, N> retval {};
+
+        size_t i = 0;
+        for (const std::string_view token : split(str, delimiter, empty_tokens)) {
+            if (i == N) break;
+            retval[i] = token;
+            ++i;
+        }
+
+        return retval;
+    }
+
+    /**
+     * std::stoi for string views: accepts a sign, even a leading +.
+     * Returns 0 if the token is not a number.
+     */
+    template <typename Int = int>
+    [[nodiscard]] Int to_int(std::string_view token) {
+        if (token.starts_with('+')) token.remove_prefix(1);
+
+        Int value = 0;
+        std::from_chars(token.data(), token.data() + token.size(), value);
+        return value;
+    }
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "flat_hash.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Interning of names into dense ids, so solvers keyed by names can use
+// vectors and matrices instead of maps of strings.
+//
+// bj::SymbolTable cities;
+// bj::SymbolMatrix<int> distances;
+// distances(cities.intern("London"), cities.intern("Dublin")) = 464;
+
+namespace bj {
+    using SymbolId = std::uint32_t;
+
+    /** Gives to each distinct name a dense id, in order of first intern */
+    class SymbolTable {
+        std::deque<std::string> m_names;    // A deque keeps the views of m_ids valid
+        bj::FlatHashMap<std::string_view, SymbolId> m_ids;
+
+    public:
+        SymbolTable() = default;
+
+        /** The copy owns its names, so its index is rebuilt on them */
+        SymbolTable(const SymbolTable & other) {
+            for (const std::string & name : other.m_names) intern(name);
+        }
+
+        SymbolTable & operator=(const SymbolTable & other) {
+            if (this != &other) {
+                m_names.clear();
+                m_ids.clear();
+                for (const std::string & name : other.m_names) intern(name);
+            }
+
+            return *this;
+        }
+
+        SymbolTable(SymbolTable &&) = default;
+        SymbolTable & operator=(SymbolTable &&) = default;
+
+        /** The id of the name, that is created if the name is new */
+        SymbolId intern(std::string_view name) {
+            if (const auto it = m_ids.find(name); it != m_ids.end()) {
+                return it->second;
+            }
+
+            const SymbolId id = static_cast<SymbolId>(m_names.size());
+            const std::string & stored = m_names.emplace_back(name);
+            m_ids.try_emplace(std::string_view(stored), id);
+            return id;
+        }
+
+        [[nodiscard]] std::optional<SymbolId> find(std::string_view name) const {
+            const auto it = m_ids.find(name);
+            if (it == m_ids.end()) return std::nullopt;
+            return it->second;
+        }
+
+        [[nodiscard]] const std::string & name(SymbolId id) const { return m_names[id]; }
+        [[nodiscard]] std::size_t size() const noexcept { return m_names.size(); }
+    };
+
+    /**
+     * A vector indexed by symbol ids. Accessing an id past the end grows the
+     * vector, so values can be filled while the names are being interned.
+     */
+    template <typename T>
+    class SymbolVector {
+        std::vector<T> m_values;
+
+    public:
+        SymbolVector() = default;
+        explicit SymbolVector(std::size_t size, const T & value = T()) : m_values(size, value) {}
+
+        T & operator[](SymbolId id) {
+            if (id >= m_values.size()) m_values.resize(id + 1);
+            return m_values[id];
+        }
+
+        [[nodiscard]] const T & operator[](SymbolId id) const { return m_values[id]; }
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_values.size(); }
+        void resize(std::size_t size) { m_values.resize(size); }
+
+        [[nodiscard]] auto begin()       noexcept { return m_values.begin(); }
+        [[nodiscard]] auto end()         noexcept { return m_values.end();   }
+        [[nodiscard]] auto begin() const noexcept { return m_values.begin(); }
+        [[nodiscard]] auto end()   const noexcept { return m_values.end();   }
+    };
+
+    /**
+     * A square matrix indexed by pairs of symbol ids, stored row major in
+     * one buffer. Writing past the current size grows the matrix. Like a
+     * vector, the buffer is allocated for more symbols than the size, and
+     * its capacity doubles when it is full, so the matrix can be filled
+     * while the names are being interned.
+     */
+    template <typename T>
+    class SymbolMatrix {
+        std::size_t m_size = 0;
+        std::size_t m_capacity = 0;         // Number of symbols of the buffer, and length of a row
+        std::vector<T> m_values;
+
+        /** Moves the values into a buffer for capacity symbols */
+        void reallocate(std::size_t capacity) {
+            std::vector<T> values(capacity * capacity);
+            for (std::size_t row = 0 ; row != m_size ; ++row) {
+                for (std::size_t column = 0 ; column != m_size ; ++column) {
+                    values[row * capacity + column] = std::move(m_values[row * m_capacity + column]);
+                }
+            }
+
+            m_capacity = capacity;
+            m_values = std::move(values);
+        }
+
+    public:
+        SymbolMatrix() = default;
+        explicit SymbolMatrix(std::size_t size, const T & value = T())
+        : m_size(size), m_capacity(size), m_values(size * size, value) {}
+
+        /** Changes the number of symbols, keeping the existing values */
+        void resize(std::size_t size) {
+            if (size > m_capacity) {
+                reallocate(std::max(size, 2 * m_capacity));
+            } else if (size < m_size) {
+                // The removed cells get back to T() if the matrix grows again
+                for (std::size_t row = 0 ; row != m_size ; ++row) {
+                    const std::size_t first_column = row < size ? size : 0;
+                    for (std::size_t column = first_column ; column != m_size ; ++column) {
+                        m_values[row * m_capacity + column] = T();
+                    }
+                }
+            }
+
+            m_size = size;
+        }
+
+        T & operator()(SymbolId row, SymbolId column) {
+            if (row >= m_size || column >= m_size) resize(std::max(row, column) + std::size_t(1));
+            return m_values[row * m_capacity + column];
+        }
+
+        [[nodiscard]] const T & operator()(SymbolId row, SymbolId column) const {
+            return m_values[row * m_capacity + column];
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+    };
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bj {
+    /**
+     * A fixed set of worker threads that run parallel loops.
+     *
+     * The calling thread takes part in the loop, so a pool of size 1 has no
+     * worker and runs everything inline. Loops started from inside a loop
+     * are also run inline.
+     *
+     * bj::ThreadPool::shared().parallel_for(tiles.size(), [&](size_t i) { ... });
+     */
+    class ThreadPool {
+    private:
+        using Job = void (*)(void * context, std::size_t index);
+
+        std::vector<std::thread> m_workers;
+
+        std::mutex              m_submit;    // One loop at a time
+        std::mutex              m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+
+        Job          m_job     = nullptr;
+        void *       m_context = nullptr;
+        std::size_t  m_count   = 0;
+        std::atomic<std::size_t> m_next { 0 };
+        std::size_t  m_running_workers = 0;
+        std::uint64_t m_generation = 0;
+        bool         m_stop = false;
+
+        static bool & is_inside_loop() {
+            thread_local bool inside = false;
+            return inside;
+        }
+
+        void drain() {
+            while (true) {
+                const std::size_t index = m_next.fetch_add(1, std::memory_order_relaxed);
+                if (index >= m_count) return;
+                m_job(m_context, index);
+            }
+        }
+
+        void work() {
+            is_inside_loop() = true;
+            std::uint64_t seen_generation = 0;
+
+            while (true) {
+                {
+                    std::unique_lock lock(m_mutex);
+                    m_wake.wait(lock, [&] { return m_stop || m_generation != seen_generation; });
+                    if (m_stop) return;
+                    seen_generation = m_generation;
+                }
+
+                drain();
+
+                std::lock_guard lock(m_mutex);
+                if (--m_running_workers == 0) m_done.notify_one();
+            }
+        }
+
+    public:
+        /** Creates a pool that runs loops on nb_threads threads, including the caller */
+        explicit ThreadPool(std::size_t nb_threads) {
+            for (std::size_t i = 1 ; i < nb_threads ; ++i) {
+                m_workers.emplace_back([this] { work(); });
+            }
+        }
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool & operator=(const ThreadPool &) = delete;
+
+        ~ThreadPool() {
+            {
+                std::lock_guard lock(m_mutex);
+                m_stop = true;
+            }
+            m_wake.notify_all();
+
+            for (std::thread & worker : m_workers) worker.join();
+        }
+
+        /** The pool shared by the whole program, with one thread per core */
+        static ThreadPool & shared() {
+            static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+            return pool;
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_workers.size() + 1; }
+
+        /** Calls function(i) for every i in [0, count[, and waits for all of them */
+        template <typename Function>
+        void parallel_for(std::size_t count, Function && function) {
+            if (m_workers.empty() || count <= 1 || is_inside_loop()) {
+                for (std::size_t i = 0 ; i != count ; ++i) function(i);
+                return;
+            }
+
+            std::lock_guard submit(m_submit);
+
+            {
+                std::lock_guard lock(m_mutex);
+                m_job = [](void * context, std::size_t index) {
+                    (*static_cast<Function *>(context))(index);
+                };
+                m_context = &function;
+                m_count = count;
+                m_next.store(0, std::memory_order_relaxed);
+                m_running_workers = m_workers.size();
+                ++m_generation;
+            }
+            m_wake.notify_all();
+
+            is_inside_loop() = true;
+            drain();
+            is_inside_loop() = false;
+
+            std::unique_lock lock(m_mutex);
+            m_done.wait(lock, [&] { return m_running_workers == 0; });
+        }
+    };
+}
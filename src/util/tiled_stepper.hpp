@@ -0,0 +1,107 @@
+#pragma once
+
+#include "isa.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bj {
+    /**
+     * Schedules the generations of a dense cellular automaton by tiles, on
+     * the shared thread pool.
+     *
+     * The automaton owns its two buffers (current and next generation) and
+     * gives to `step` a function that computes the next generation of one
+     * tile and returns if it changed. Tiles read their halo directly from
+     * the current buffer.
+     *
+     * When the rule is local (a cell only depends on cells closer than a
+     * tile size), a tile whose 3x3 block of tiles did not change during the
+     * previous generation is skipped: the next buffer already holds its
+     * content, as it was the same two generations ago.
+     *
+     * The tiles are computed with the instruction set picked by bj::isa.
+     */
+    class TiledStepper {
+    public:
+        /** Cells [left, right[ x [top, bottom[ */
+        struct Tile {
+            std::size_t left;
+            std::size_t top;
+            std::size_t right;
+            std::size_t bottom;
+        };
+
+        static constexpr std::size_t Default_Tile_Size = 128;
+
+    private:
+        std::vector<Tile> m_tiles;
+        std::size_t m_tiles_x;
+        std::size_t m_tiles_y;
+        bool m_is_local;
+        bool m_first_step = true;
+        std::vector<std::uint8_t> m_changed;
+        std::vector<std::uint8_t> m_next_changed;
+        std::vector<std::size_t> m_active;
+
+        [[nodiscard]] bool is_stable_around(std::size_t tx, std::size_t ty) const noexcept {
+            const std::size_t x_min = tx == 0 ? 0 : tx - 1;
+            const std::size_t y_min = ty == 0 ? 0 : ty - 1;
+            const std::size_t x_max = std::min(tx + 1, m_tiles_x - 1);
+            const std::size_t y_max = std::min(ty + 1, m_tiles_y - 1);
+
+            for (std::size_t y = y_min ; y <= y_max ; ++y) {
+                for (std::size_t x = x_min ; x <= x_max ; ++x) {
+                    if (m_changed[y * m_tiles_x + x]) return false;
+                }
+            }
+
+            return true;
+        }
+
+    public:
+        TiledStepper(std::size_t width, std::size_t height, bool is_local, std::size_t tile_size = Default_Tile_Size)
+        : m_tiles_x((width  + tile_size - 1) / tile_size),
+          m_tiles_y((height + tile_size - 1) / tile_size),
+          m_is_local(is_local) {
+            for (std::size_t ty = 0 ; ty != m_tiles_y ; ++ty) {
+                for (std::size_t tx = 0 ; tx != m_tiles_x ; ++tx) {
+                    m_tiles.push_back(Tile {
+                        tx * tile_size, ty * tile_size,
+                        std::min(width, (tx + 1) * tile_size), std::min(height, (ty + 1) * tile_size)
+                    });
+                }
+            }
+
+            m_changed.resize(m_tiles.size(), 1);
+            m_next_changed.resize(m_tiles.size(), 0);
+        }
+
+        /**
+         * Computes one generation with compute_tile(const Tile &) -> bool.
+         * Returns true if any tile changed.
+         */
+        template <typename ComputeTile>
+        bool step(ComputeTile compute_tile) {
+            m_active.clear();
+
+            for (std::size_t i = 0 ; i != m_tiles.size() ; ++i) {
+                const bool skip = !m_first_step && m_is_local && is_stable_around(i % m_tiles_x, i / m_tiles_x);
+                m_next_changed[i] = 0;
+                if (!skip) m_active.push_back(i);
+            }
+
+            ThreadPool::shared().parallel_for(m_active.size(), [&](std::size_t i) {
+                const std::size_t tile = m_active[i];
+                const bool changed = bj::isa::dispatch([&]() -> bool { return compute_tile(m_tiles[tile]); });
+                m_next_changed[tile] = changed ? 1 : 0;
+            });
+
+            m_first_step = false;
+            m_changed.swap(m_next_changed);
+            return std::find(m_changed.begin(), m_changed.end(), 1) != m_changed.end();
+        }
+    };
+}
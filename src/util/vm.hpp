@@ -0,0 +1,190 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// A small bytecode interpreter, shared by the days that run programs.
+//
+// A day describes its instruction set with a class:
+//
+// struct Assembly {
+//     enum Opcode : std::uint8_t { Inc, Jmp };
+//     static constexpr std::array<std::string_view, 2> Opcode_Names { "inc", "jmp" };
+//
+//     bj::vm::Registers<int, 2> registers {};
+//
+//     // Does the instruction, returns the offset of the next one (1 = the next line)
+//     template <std::size_t Opcode>
+//     std::int32_t execute(const bj::vm::Instruction & instruction);
+// };
+//
+// const bj::vm::RunResult result = bj::vm::run(program, assembly);
+
+namespace bj::vm {
+    /** Fixed width bytecode: an opcode, a register and an immediate argument */
+    struct Instruction {
+        std::uint8_t opcode = 0;
+        std::uint8_t reg    = 0;
+        std::int32_t arg    = 0;
+    };
+
+    static_assert(sizeof(Instruction) == 8);
+
+    template <typename Word, std::size_t Nb_Registers>
+    using Registers = std::array<Word, Nb_Registers>;
+
+    /** Set by --trace-vm: every run prints its number of executed instructions */
+    inline bool trace = false;
+
+    /** The dispatch table has a fixed number of entries */
+    static constexpr std::size_t Max_Opcodes = 16;
+
+    enum class Stop {
+        Halted,         // The program counter left the program
+        Loop,           // An instruction was about to be executed a second time
+        InvalidOpcode   // Nothing was run: the instruction at pc has no handler
+    };
+
+    struct RunResult {
+        Stop stop;
+        std::int64_t pc;
+        std::uint64_t nb_executed;
+
+        /** True if the program halted just after its last instruction */
+        [[nodiscard]] bool ended_normally(std::size_t program_size) const noexcept {
+            return stop == Stop::Halted && pc == static_cast<std::int64_t>(program_size);
+        }
+    };
+
+    struct Options {
+        /** Stop before executing an instruction a second time */
+        bool detect_loops = false;
+        std::int64_t start_pc = 0;
+    };
+
+    namespace details {
+        template <typename Set, std::size_t... Opcodes>
+        void print_trace(const std::array<std::uint64_t, sizeof...(Opcodes)> & counts, std::index_sequence<Opcodes...>) {
+            std::uint64_t total = 0;
+            for (const std::uint64_t count : counts) total += count;
+
+            std::cerr << "[vm] " << total << " instructions:";
+            ((std::cerr << ' ' << Set::Opcode_Names[Opcodes] << '=' << counts[Opcodes]), ...);
+            std::cerr << '\n';
+        }
+
+        template <bool Trace, typename Set>
+        RunResult run(const std::vector<Instruction> & program, Set & set, const Options & options) {
+            constexpr std::size_t Nb_Opcodes = Set::Opcode_Names.size();
+            static_assert(Nb_Opcodes <= Max_Opcodes, "Too many opcodes for the dispatch table");
+
+            const std::int64_t size = static_cast<std::int64_t>(program.size());
+            const Instruction * const code = program.data();
+            std::vector<std::uint8_t> visited(options.detect_loops ? program.size() : 0, 0);
+            std::array<std::uint64_t, Nb_Opcodes> counts {};
+
+            std::int64_t pc = options.start_pc;
+            std::uint64_t nb_executed = 0;
+            Stop stop = Stop::Halted;
+
+            // Returns false if the execution is over
+            const auto fetch = [&]() {
+                if (pc < 0 || pc >= size) {
+                    stop = Stop::Halted;
+                    return false;
+                }
+
+                if (options.detect_loops) {
+                    if (visited[pc]) {
+                        stop = Stop::Loop;
+                        return false;
+                    }
+                    visited[pc] = 1;
+                }
+
+                return true;
+            };
+
+#if defined(__GNUC__)
+            // Threaded code: every handler jumps directly to the next one.
+            // Labels as values are a GNU extension.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+            static void * const dispatch_table[Max_Opcodes] = {
+                &&op_0, &&op_1, &&op_2,  &&op_3,  &&op_4,  &&op_5,  &&op_6,  &&op_7,
+                &&op_8, &&op_9, &&op_10, &&op_11, &&op_12, &&op_13, &&op_14, &&op_15
+            };
+
+#define BJ_VM_DISPATCH()                                   \
+            do {                                           \
+                if (!fetch()) goto done;                   \
+                goto *dispatch_table[code[pc].opcode];     \
+            } while (false)
+
+#define BJ_VM_OPCODE(I)                                                \
+            op_##I:                                                    \
+            if constexpr (I < Nb_Opcodes) {                            \
+                if constexpr (Trace) ++counts[I];                      \
+                ++nb_executed;                                         \
+                pc += set.template execute<I>(code[pc]);               \
+                BJ_VM_DISPATCH();                                      \
+            } else {                                                   \
+                /* run checked the opcodes */                          \
+                __builtin_unreachable();                               \
+            }
+
+            BJ_VM_DISPATCH();
+            BJ_VM_OPCODE(0)  BJ_VM_OPCODE(1)  BJ_VM_OPCODE(2)  BJ_VM_OPCODE(3)
+            BJ_VM_OPCODE(4)  BJ_VM_OPCODE(5)  BJ_VM_OPCODE(6)  BJ_VM_OPCODE(7)
+            BJ_VM_OPCODE(8)  BJ_VM_OPCODE(9)  BJ_VM_OPCODE(10) BJ_VM_OPCODE(11)
+            BJ_VM_OPCODE(12) BJ_VM_OPCODE(13) BJ_VM_OPCODE(14) BJ_VM_OPCODE(15)
+
+#undef BJ_VM_OPCODE
+#undef BJ_VM_DISPATCH
+
+        done:
+#pragma GCC diagnostic pop
+#else
+            while (fetch()) {
+                const Instruction & instruction = code[pc];
+                ++nb_executed;
+
+                [&]<std::size_t... I>(std::index_sequence<I...>) {
+                    ((instruction.opcode == I
+                        ? (Trace ? ++counts[I] : 0, pc += set.template execute<I>(instruction), true)
+                        : false) || ...);
+                }(std::make_index_sequence<Nb_Opcodes>());
+            }
+#endif
+
+            if constexpr (Trace) {
+                print_trace<Set>(counts, std::make_index_sequence<Nb_Opcodes>());
+            }
+
+            return RunResult { stop, pc, nb_executed };
+        }
+    }
+
+    /**
+     * Runs the program until it halts (or loops, if asked).
+     *
+     * The opcodes are checked before the run: if one of them is not in the
+     * instruction set, nothing is executed and the result is InvalidOpcode.
+     */
+    template <typename Set>
+    RunResult run(const std::vector<Instruction> & program, Set & set, const Options & options = {}) {
+        for (std::size_t i = 0 ; i != program.size() ; ++i) {
+            if (program[i].opcode >= Set::Opcode_Names.size()) {
+                return RunResult { Stop::InvalidOpcode, static_cast<std::int64_t>(i), 0 };
+            }
+        }
+
+        if (trace) return details::run<true >(program, set, options);
+        else       return details::run<false>(program, set, options);
+    }
+}